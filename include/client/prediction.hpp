@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+
+#include "sentinel/net/protocol/snapshot.hpp"
+#include "sentinel/sim/sim_update.hpp"
+
+// ------------------------------------------------------------
+// Local prediction
+// ------------------------------------------------------------
+// The local drone runs ahead of the server: every fixed tick the
+// input is applied at once with sim_update and kept until the server
+// reports it applied. Each PlayerState rewinds to the authoritative
+// body and replays the inputs the server has not seen yet, so local
+// control has no latency at any RTT.
+//
+// Any correction moves the simulated body immediately, but the drawn
+// drone keeps a decaying offset from it so the fix is blended in
+// rather than snapped to.
+class LocalPrediction {
+public:
+    // Reset to the server's spawn; nothing is predicted until the
+    // first PlayerState gives the tick rate.
+    void reset(const SimPlayer& spawn);
+
+    bool  ready() const { return dt > 0.0f; }
+    float tick_dt() const { return dt; }
+
+    // One tick of local input; returns its command tick for InputCmd
+    uint32_t step(const SimInput& input);
+
+    void reconcile(const PlayerState& state);
+
+    // Drawn drone: the last two ticks blended by alpha in [0, 1],
+    // plus the correction offset. decay() shrinks the offset.
+    SimPlayer render(float alpha) const;
+    void      decay(float frame_dt);
+
+    // Distance of the most recent correction, metres
+    float last_error() const { return error; }
+
+private:
+    static constexpr uint32_t HISTORY = 128; // ticks, power of two
+
+    struct Pending {
+        uint32_t tick = 0;
+        SimInput input;
+    };
+
+    Pending pending[HISTORY];
+
+    SimWorld  world;
+    SimPlayer current;
+    SimPlayer previous;
+
+    float    dt = 0.0f;
+    uint32_t next_tick  = 1; // command tick of the next step
+    uint32_t state_tick = 0; // server tick of the newest PlayerState
+
+    float ox = 0.0f, oy = 0.0f, oz = 0.0f, oyaw = 0.0f; // correction
+    float error = 0.0f;
+};
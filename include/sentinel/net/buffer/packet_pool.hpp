@@ -0,0 +1,141 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// ------------------------------------------------------------
+// Packet buffer pool
+// ------------------------------------------------------------
+// Fixed-size buffers carved out of slabs that are allocated on demand
+// and never freed until the pool goes. A PacketRef is a counted view
+// of part of one buffer: copies share the bytes, and the buffer goes
+// back on the free list when the last view is dropped.
+//
+// This is what lets a datagram be received once, parsed and patched
+// where it lies, and then held by every recipient that still has to
+// send it, instead of being copied at each step.
+//
+// Neither the pool nor its refs are thread-safe; both belong to one
+// thread, and every ref must be dropped before its pool.
+
+class PacketPool;
+
+struct PacketPoolStats {
+    size_t   capacity  = 0; // buffers allocated so far
+    size_t   in_use    = 0;
+    size_t   peak      = 0; // most ever in use at once
+    uint64_t exhausted = 0; // acquire() calls refused at max_buffers
+};
+
+class PacketRef {
+public:
+    PacketRef() = default;
+    PacketRef(const PacketRef& o)
+        : buf(o.buf), offset(o.offset), length(o.length) {
+        if (buf)
+            ++buf->refs;
+    }
+    PacketRef(PacketRef&& o) noexcept
+        : buf(o.buf), offset(o.offset), length(o.length) {
+        o.buf = nullptr;
+        o.offset = o.length = 0;
+    }
+    PacketRef& operator=(PacketRef o) noexcept {
+        std::swap(buf, o.buf);
+        std::swap(offset, o.offset);
+        std::swap(length, o.length);
+        return *this;
+    }
+    ~PacketRef() { reset(); }
+
+    void reset();
+
+    explicit operator bool() const { return buf != nullptr; }
+
+    // Writing is for the view's own bytes: other views of the same
+    // buffer never overlap one being filled or patched
+    uint8_t*       data()       { return buf->bytes + offset; }
+    const uint8_t* data() const { return buf->bytes + offset; }
+    size_t         size() const { return length; }
+
+    // Room from the start of the view to the end of the buffer
+    size_t capacity() const;
+    void   resize(size_t size) { length = uint32_t(size); } // <= capacity()
+
+    // Another view of bytes [at, at + size) of this one
+    PacketRef slice(size_t at, size_t size) const;
+
+    bool     unique() const { return buf && buf->refs == 1; }
+    uint32_t refs() const { return buf ? buf->refs : 0; }
+
+    // Copies a packet struct over the view's bytes from `at`
+    template <class T>
+    void store(const T& value, size_t at = 0) {
+        std::memcpy(data() + at, &value, sizeof(value));
+    }
+
+private:
+    friend class PacketPool;
+
+    struct Buffer {
+        PacketPool* pool = nullptr;
+        Buffer*     next_free = nullptr;
+        uint8_t*    bytes = nullptr;
+        uint32_t    refs = 0;
+    };
+
+    PacketRef(Buffer* b, uint32_t off, uint32_t len)
+        : buf(b), offset(off), length(len) {}
+
+    Buffer*  buf    = nullptr;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+class PacketPool {
+public:
+    // Buffers of buffer_bytes each, slab_buffers per slab, never more
+    // than max_buffers in all
+    PacketPool(size_t buffer_bytes, size_t slab_buffers, size_t max_buffers);
+    ~PacketPool();
+
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+    // An empty view of a whole free buffer; resize() it once filled.
+    // Empty ref once max_buffers are in use.
+    PacketRef acquire();
+
+    // acquire() and copy; empty ref if the bytes do not fit
+    PacketRef copy(const void* data, size_t size);
+
+    size_t          buffer_bytes() const { return bytes_per_buffer; }
+    PacketPoolStats stats() const;
+
+private:
+    friend class PacketRef;
+
+    using Buffer = PacketRef::Buffer;
+
+    struct Slab {
+        std::unique_ptr<uint8_t[]> bytes;
+        std::unique_ptr<Buffer[]>  buffers;
+    };
+
+    bool grow();
+    void release(Buffer* b);
+
+    size_t bytes_per_buffer;
+    size_t slab_size;
+    size_t max_buffers;
+
+    std::vector<Slab> slabs;
+    Buffer*           free_list = nullptr;
+
+    size_t   in_use    = 0;
+    size_t   peak      = 0;
+    uint64_t exhausted = 0;
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <span>
 
 #if defined(_WIN32)
     #define WIN32_LEAN_AND_MEAN
@@ -12,9 +13,13 @@
 #endif
 
 #include "sentinel/net/protocol/snapshot.hpp"
+#include "sentinel/net/transport/udp_socket.hpp"
 
 // lifecycle
 bool net_init(const char* host, uint16_t port);
+// runs net_* over a socket made elsewhere, e.g. by a SimNetwork;
+// takes ownership
+void net_init_socket(UdpSocket* socket);
 void net_shutdown();
 
 // raw transport
@@ -23,6 +28,11 @@ ssize_t net_send_raw_to(const void* data, size_t size,
 ssize_t net_recv_raw_from(void* out, size_t max,
                           sockaddr_in& from);
 
+// batched raw transport; see UdpSocket::send_batch / recv_batch.
+// The receive side never waits: 0 means nothing has arrived.
+int net_send_raw_batch(std::span<const OutPacket> packets);
+int net_recv_raw_batch(std::span<InPacket> packets);
+
 // snapshot helpers
 bool net_send_snapshot_to(const Snapshot& s,
                            const sockaddr_in& addr);
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// ------------------------------------------------------------
+// BitWriter / BitReader
+// ------------------------------------------------------------
+// LSB-first bit packing into a caller-owned byte buffer. Values are
+// at most 32 bits wide. Both sides stop (and report failure) instead
+// of running past the end of the buffer.
+
+class BitWriter {
+public:
+    BitWriter(uint8_t* out, size_t capacity)
+        : data(out), cap_bits(capacity * 8) {}
+
+    bool write(uint32_t value, int bits) {
+        if (bits_used + size_t(bits) > cap_bits) {
+            overflow = true;
+            return false;
+        }
+
+        if (bits < 32)
+            value &= (uint32_t(1) << bits) - 1;
+
+        scratch |= uint64_t(value) << scratch_bits;
+        scratch_bits += bits;
+        bits_used += size_t(bits);
+
+        while (scratch_bits >= 8) {
+            data[byte_pos++] = uint8_t(scratch);
+            scratch >>= 8;
+            scratch_bits -= 8;
+        }
+
+        return true;
+    }
+
+    bool write_bool(bool v) { return write(v ? 1u : 0u, 1); }
+
+    // Pads the final partial byte with zeros
+    void flush() {
+        if (scratch_bits > 0) {
+            data[byte_pos++] = uint8_t(scratch);
+            scratch = 0;
+            scratch_bits = 0;
+        }
+    }
+
+    size_t bits_written() const { return bits_used; }
+    size_t bits_free() const { return cap_bits - bits_used; }
+    size_t bytes_written() const { return (bits_used + 7) / 8; }
+    bool   failed() const { return overflow; }
+
+private:
+    uint8_t* data;
+    size_t   cap_bits;
+    size_t   bits_used = 0;
+    size_t   byte_pos = 0;
+
+    uint64_t scratch = 0;
+    int      scratch_bits = 0;
+    bool     overflow = false;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* in, size_t size)
+        : data(in), size_bytes(size) {}
+
+    bool read(uint32_t& value, int bits) {
+        if (bits_used + size_t(bits) > size_bytes * 8) {
+            overflow = true;
+            return false;
+        }
+
+        while (scratch_bits < bits) {
+            scratch |= uint64_t(data[byte_pos++]) << scratch_bits;
+            scratch_bits += 8;
+        }
+
+        value = uint32_t(bits < 32 ? scratch & ((uint64_t(1) << bits) - 1)
+                                   : scratch & 0xFFFFFFFFu);
+        scratch >>= bits;
+        scratch_bits -= bits;
+        bits_used += size_t(bits);
+        return true;
+    }
+
+    bool read_bool(bool& v) {
+        uint32_t bit = 0;
+        if (!read(bit, 1))
+            return false;
+
+        v = bit != 0;
+        return true;
+    }
+
+    size_t bits_read() const { return bits_used; }
+    size_t bytes_read() const { return (bits_used + 7) / 8; }
+    bool   failed() const { return overflow; }
+
+private:
+    const uint8_t* data;
+    size_t size_bytes;
+    size_t bits_used = 0;
+    size_t byte_pos = 0;
+
+    uint64_t scratch = 0;
+    int      scratch_bits = 0;
+    bool     overflow = false;
+};
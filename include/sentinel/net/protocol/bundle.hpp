@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "sentinel/net/protocol/snapshot.hpp"
+
+// ------------------------------------------------------------
+// Bundles
+// ------------------------------------------------------------
+// Several complete packets in one datagram, so a client's whole tick
+// (PlayerState, world parts, reliable messages) costs as few
+// datagrams as possible. After the header, records run to the end:
+//   uint16_t  size
+//   size      bytes of one packet, its own header included
+// A bundle never nests another bundle.
+
+constexpr size_t BUNDLE_MTU = 1200; // same conservative path MTU as the world
+
+struct BundleHeader {
+    PacketHeader hdr{ PacketType::BUNDLE };
+};
+
+constexpr size_t BUNDLE_RECORD_BYTES = sizeof(uint16_t);
+
+// Calls fn(data, size) for each packet in a bundle, in order. False
+// (and nothing called) if the records do not tile the datagram.
+template <class Fn>
+bool read_bundle(const uint8_t* data, size_t size, Fn&& fn) {
+    if (size < sizeof(BundleHeader))
+        return false;
+
+    size_t pos = sizeof(BundleHeader);
+    while (pos < size) {
+        uint16_t len = 0;
+        if (pos + BUNDLE_RECORD_BYTES > size)
+            return false;
+        std::memcpy(&len, data + pos, sizeof(len));
+
+        pos += BUNDLE_RECORD_BYTES + len;
+        if (len < sizeof(PacketHeader) || pos > size)
+            return false;
+    }
+
+    pos = sizeof(BundleHeader);
+    while (pos < size) {
+        uint16_t len = 0;
+        std::memcpy(&len, data + pos, sizeof(len));
+        pos += BUNDLE_RECORD_BYTES;
+
+        fn(data + pos, size_t(len));
+        pos += len;
+    }
+
+    return true;
+}
@@ -1,10 +1,14 @@
 #pragma once
 #include <cstdint>
 
+#include "sentinel/net/protocol/snapshot.hpp"
+
 constexpr int MAX_NAME_LEN = 24;
 constexpr int MAX_CHAT_TEXT = 96;
 
 struct ChatMessage {
+    PacketHeader hdr{ PacketType::CHAT };
+
     uint32_t player_id;
     char name[MAX_NAME_LEN];
     char text[MAX_CHAT_TEXT];
@@ -0,0 +1,117 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "sentinel/net/protocol/snapshot.hpp"
+
+// ------------------------------------------------------------
+// Packet dispatch
+// ------------------------------------------------------------
+// A 256-entry table keyed on PacketHeader::type, built at compile time
+// from the packet structs a receiver handles. Each struct's type comes
+// from its default `hdr`, and its size is the length check.
+//
+//   using Dispatch = PacketDispatcher<Handler, Context, Snapshot, ...>;
+//   Dispatch::dispatch(handler, data, size, ctx);
+//
+// calls handler.on_packet(const Snapshot&, const Context&). Variable-
+// length packets (PacketTraits<T>::variable) must be at least sizeof(T)
+// and get on_packet(const T&, data, size, ctx) to parse the rest.
+
+template <class T>
+struct PacketTraits {
+    static constexpr bool variable = false;
+};
+
+struct WorldSnapshotHeader;
+struct ReliablePacket;
+struct BundleHeader;
+
+template <>
+struct PacketTraits<WorldSnapshotHeader> {
+    static constexpr bool variable = true;
+};
+
+template <>
+struct PacketTraits<ReliablePacket> {
+    static constexpr bool variable = true;
+};
+
+template <>
+struct PacketTraits<BundleHeader> {
+    static constexpr bool variable = true;
+};
+
+template <class T>
+constexpr PacketType packet_type() {
+    return T{}.hdr.type;
+}
+
+template <class Handler, class Context, class... Packets>
+class PacketDispatcher {
+public:
+    // False (and nothing called) for a short datagram, another protocol
+    // version, an unhandled type or a bad length.
+    static bool dispatch(Handler& h, const uint8_t* data, size_t size,
+                         const Context& ctx) {
+        if (size < sizeof(PacketHeader))
+            return false;
+
+        PacketHeader hdr{};
+        std::memcpy(&hdr, data, sizeof(hdr));
+
+        const Entry& e = table[uint8_t(hdr.type)];
+
+        if (hdr.version != PROTOCOL_VERSION || !e.fn ||
+            (e.variable ? size < e.size : size != e.size))
+            return false;
+
+        e.fn(h, data, size, ctx);
+        return true;
+    }
+
+private:
+    using Fn = void (*)(Handler&, const uint8_t*, size_t, const Context&);
+
+    struct Entry {
+        Fn     fn = nullptr;
+        size_t size = 0;
+        bool   variable = false;
+    };
+
+    template <class P>
+    static void invoke(Handler& h, const uint8_t* data, size_t size,
+                       const Context& ctx) {
+        P p;
+        std::memcpy(&p, data, sizeof(p));
+
+        if constexpr (PacketTraits<P>::variable)
+            h.on_packet(p, data, size, ctx);
+        else
+            h.on_packet(p, ctx);
+    }
+
+    static constexpr bool types_unique() {
+        const PacketType types[] = { packet_type<Packets>()... };
+        for (size_t i = 0; i < sizeof...(Packets); ++i)
+            for (size_t j = i + 1; j < sizeof...(Packets); ++j)
+                if (types[i] == types[j])
+                    return false;
+        return true;
+    }
+
+    static_assert(sizeof...(Packets) > 0, "dispatch needs packet types");
+    static_assert(types_unique(), "two packets share a PacketType");
+
+    static constexpr std::array<Entry, 256> build() {
+        std::array<Entry, 256> t{};
+        ((t[uint8_t(packet_type<Packets>())] =
+              Entry{ &invoke<Packets>, sizeof(Packets),
+                     PacketTraits<Packets>::variable }), ...);
+        return t;
+    }
+
+    static constexpr std::array<Entry, 256> table = build();
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+// ------------------------------------------------------------
+// Fixed-point quantization for snapshot fields
+// ------------------------------------------------------------
+
+constexpr float QUANT_PI = 3.14159265358979f;
+
+// Maps [min, max] onto 2^bits - 1 evenly spaced steps. Values outside
+// the range are clamped, so the bound only holds inside it.
+struct QuantRange {
+    float   min;
+    float   max;
+    uint8_t bits;
+
+    constexpr uint32_t steps() const {
+        return bits >= 32 ? 0xFFFFFFFFu : (uint32_t(1) << bits) - 1;
+    }
+
+    // Worst-case |decoded - original| for an in-range value
+    constexpr float max_error() const {
+        return (max - min) / float(steps()) * 0.5f;
+    }
+};
+
+inline uint32_t quantize(float v, const QuantRange& r) {
+    if (!(v > r.min)) return 0;          // also catches NaN
+    if (v >= r.max)   return r.steps();
+
+    double t = (double(v) - r.min) / (double(r.max) - r.min);
+    return uint32_t(t * r.steps() + 0.5);
+}
+
+inline float dequantize(uint32_t q, const QuantRange& r) {
+    double t = double(q) / r.steps();
+    return float(r.min + t * (double(r.max) - r.min));
+}
+
+// Angles wrap instead of clamping: the full turn is split into 2^bits
+// steps and decodes into [-pi, pi).
+inline uint32_t quantize_angle(float a, uint8_t bits) {
+    double turns = double(a) / (2.0 * QUANT_PI);
+    turns -= std::floor(turns);
+
+    uint32_t full = uint32_t(1) << bits;
+    return uint32_t(turns * full + 0.5) & (full - 1);
+}
+
+inline float dequantize_angle(uint32_t q, uint8_t bits) {
+    double a = double(q) * (2.0 * QUANT_PI) / double(uint32_t(1) << bits);
+    if (a >= QUANT_PI)
+        a -= 2.0 * QUANT_PI;
+
+    return float(a);
+}
+
+constexpr float angle_max_error(uint8_t bits) {
+    return QUANT_PI / float(uint32_t(1) << bits);
+}
+
+// Per-field ranges for world snapshot entities. Server and client must
+// agree, so both use DEFAULT_SNAPSHOT_QUANTIZATION unless a test or
+// benchmark passes its own.
+struct SnapshotQuantization {
+    QuantRange x { -4096.0f, 4096.0f, 20 };   // ~0.004 error
+    QuantRange y {  -256.0f, 1024.0f, 18 };   // ~0.0025
+    QuantRange z { -4096.0f, 4096.0f, 20 };
+
+    uint8_t    yaw_bits = 12;                 // ~0.045 deg
+    QuantRange pitch { -QUANT_PI * 0.5f, QUANT_PI * 0.5f, 10 };
+
+    QuantRange vel { -64.0f, 64.0f, 12 };     // vx, vy, vz; ~0.016
+};
+
+inline constexpr SnapshotQuantization DEFAULT_SNAPSHOT_QUANTIZATION{};
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "sentinel/net/protocol/snapshot.hpp"
+#include "sentinel/net/protocol/chat.hpp"
+
+// ------------------------------------------------------------
+// Reliable packets
+// ------------------------------------------------------------
+// Chat and missile events travel in RELIABLE packets. Each packet has
+// its own sequence number and carries any number of messages back to
+// back after the header:
+//   ReliableRecord  message id and size
+//   size bytes      the message: a complete packet struct, header
+//                   included, dispatched as if it arrived on its own
+// Message ids count up per connection and messages are delivered in
+// id order. The receiver acks packets, not messages, with ReliableAck
+// on its regular per-tick traffic; a message is done once any packet
+// carrying it is acked.
+
+constexpr size_t RELIABLE_MTU         = 1200;
+constexpr size_t RELIABLE_MAX_MESSAGE = 128; // bytes
+
+static_assert(sizeof(ChatMessage) <= RELIABLE_MAX_MESSAGE,
+              "chat must fit a reliable message");
+
+struct ReliablePacket {
+    PacketHeader hdr{ PacketType::RELIABLE };
+
+    uint16_t seq = 0;
+    uint8_t  count = 0; // records that follow
+    uint8_t  reserved = 0;
+
+    ReliableAck acks;
+};
+
+struct ReliableRecord {
+    uint16_t id = 0;
+    uint16_t size = 0;
+};
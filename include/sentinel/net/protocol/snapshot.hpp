@@ -1,21 +1,62 @@
 ﻿#pragma once
 #include <cstdint>
 
-enum class PacketType : uint32_t {
+// Bump whenever a wire struct changes; packets from another version
+// are dropped at dispatch.
+constexpr uint8_t PROTOCOL_VERSION = 5;
+
+enum class PacketType : uint8_t {
     HELLO = 1,
     SNAPSHOT = 2,
     INPUT = 3,
 
     MISSILE_FIRE = 4,
-    MISSILE_EXPLODE = 5
+    MISSILE_EXPLODE = 5,
+
+    WORLD_SNAPSHOT = 6,
+    SNAPSHOT_ACK = 7,
+
+    CHAT = 8,
+
+    PLAYER_STATE = 9,
+
+    RELIABLE = 10,
+
+    BUNDLE = 11
 };
 
 
 
+// Every datagram starts with this (see dispatch.hpp)
 struct PacketHeader {
-    PacketType type;
+    PacketType type{};
+    uint8_t    version  = PROTOCOL_VERSION;
+    uint16_t   reserved = 0;
+};
+
+static_assert(sizeof(PacketHeader) == 4, "header layout is part of the protocol");
+
+// Client -> server: ask for a session; answered with a Snapshot
+// carrying the assigned player_id
+struct Hello {
+    PacketHeader hdr{ PacketType::HELLO };
+};
+
+// Reliable channel acks (see protocol/reliable.hpp), carried by the
+// packets each side sends every tick anyway. Bit i of `bits` means
+// packet ack - i arrived; no bits set = nothing received yet.
+struct ReliableAck {
+    uint16_t ack = 0;
+    uint16_t reserved = 0;
+    uint32_t bits = 0;
 };
 
+enum : uint8_t {
+    INPUT_BUTTON_BOOST = 1 << 0
+};
+
+// Client -> server: stick input for one server tick. tick is the
+// client's own command counter, starting at 1.
 struct InputCmd {
     PacketHeader hdr{ PacketType::INPUT };
 
@@ -26,6 +67,32 @@ struct InputCmd {
     float strafe   = 0.0f;
     float yaw      = 0.0f;
     float pitch    = 0.0f;
+    float vertical = 0.0f;
+
+    uint8_t buttons = 0; // INPUT_BUTTON_*
+
+    ReliableAck acks;
+};
+
+// Server -> one client, every tick: its own player, unquantized, and
+// the newest InputCmd tick applied to it. Prediction rewinds to this
+// state and replays the commands after input_tick.
+struct PlayerState {
+    PacketHeader hdr{ PacketType::PLAYER_STATE };
+
+    uint32_t tick = 0;
+    uint32_t input_tick = 0;
+
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+
+    float yaw   = 0.0f;
+    float pitch = 0.0f;
+
+    uint8_t tick_rate = 0;
+
+    ReliableAck acks;
 };
 
 struct Snapshot {
@@ -46,6 +113,12 @@ struct Snapshot {
     float vx = 0.0f;
     float vy = 0.0f;
     float vz = 0.0f;
+
+    // Welcome only: when `tick` was scheduled on the server's own clock.
+    // server_time stays on the tick timeline (tick / tick_rate) like
+    // every world snapshot; this lets a bench on the same host place
+    // each world tick on its clock.
+    double sched_time = 0.0;
 };
 
 struct MissileFireEvent {
@@ -68,5 +141,48 @@ struct MissileExplodeEvent {
 
     float x, y, z;
     double server_time;
+
+    // Set by the server: nearest player in the blast as the shooter
+    // saw the world, 0 = none
+    uint32_t target_id = 0;
+};
+
+// ---- WORLD SNAPSHOT ----
+// One part of the world for a single server tick: WorldSnapshotHeader
+// followed by entity_count bit-packed delta records (see
+// world_snapshot.hpp). baseline_tick == 0 marks a keyframe. Time is
+// carried as the tick number; tick / tick_rate gives server seconds.
+struct WorldSnapshotHeader {
+    PacketHeader hdr{ PacketType::WORLD_SNAPSHOT };
+
+    uint32_t tick = 0;
+    uint32_t baseline_tick = 0;
+
+    uint16_t entity_count = 0;
+    uint8_t  part_index = 0;
+    uint8_t  part_count = 0;
+
+    uint8_t  tick_rate = 0;
+};
+
+// Client -> server: newest tick whose parts all arrived
+struct SnapshotAck {
+    PacketHeader hdr{ PacketType::SNAPSHOT_ACK };
+
+    uint32_t tick = 0;
 };
 
+struct EntityState {
+    uint32_t player_id = 0;
+
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+
+    float yaw   = 0.0f;
+    float pitch = 0.0f;
+
+    float vx = 0.0f;
+    float vy = 0.0f;
+    float vz = 0.0f;
+};
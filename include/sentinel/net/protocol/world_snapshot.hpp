@@ -0,0 +1,114 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "sentinel/net/protocol/snapshot.hpp"
+#include "sentinel/net/protocol/quantize.hpp"
+
+// Keep world packets under a conservative path MTU
+constexpr size_t WORLD_SNAPSHOT_MTU = 1200;
+
+// Client tracks received parts of a tick in a 64-bit mask
+constexpr size_t WORLD_SNAPSHOT_MAX_PARTS = 64;
+
+// Clients draw remote players this far behind the newest world tick.
+// Larger delay = smoother remote motion; the server rewinds hit tests
+// by the same amount.
+constexpr double INTERP_DELAY = 0.45; // seconds
+
+// ------------------------------------------------------------
+// Delta records
+// ------------------------------------------------------------
+// Records are bit-packed back to back after the header:
+//   1 bit   id is previous id + 1 (ids ascend within a part)
+//   32 bits player_id, only when the bit above is clear
+//   8 bits  field mask (ENTITY_FIELD_*)
+//   per set bit, in bit order, the quantized field value
+// A field is sent when its quantized value differs from the baseline
+// entity's. Entities missing from the baseline (and every entity of a
+// keyframe) carry ENTITY_FIELD_ALL.
+enum : uint8_t {
+    ENTITY_FIELD_X     = 1 << 0,
+    ENTITY_FIELD_Y     = 1 << 1,
+    ENTITY_FIELD_Z     = 1 << 2,
+    ENTITY_FIELD_YAW   = 1 << 3,
+    ENTITY_FIELD_PITCH = 1 << 4,
+    ENTITY_FIELD_VX    = 1 << 5,
+    ENTITY_FIELD_VY    = 1 << 6,
+    ENTITY_FIELD_VZ    = 1 << 7,
+
+    ENTITY_FIELD_ALL   = 0xFF
+};
+
+struct WorldPacket {
+    uint8_t bytes[WORLD_SNAPSHOT_MTU];
+    size_t  size = 0;
+};
+
+inline EntityState entity_from_snapshot(const Snapshot& s) {
+    EntityState e{};
+    e.player_id = s.player_id;
+    e.x = s.x;   e.y = s.y;   e.z = s.z;
+    e.yaw = s.yaw;
+    e.pitch = s.pitch;
+    e.vx = s.vx; e.vy = s.vy; e.vz = s.vz;
+    return e;
+}
+
+inline Snapshot snapshot_from_entity(const EntityState& e,
+                                     uint32_t tick, double server_time) {
+    Snapshot s{};
+    s.player_id = e.player_id;
+    s.tick = tick;
+    s.server_time = server_time;
+    s.x = e.x;   s.y = e.y;   s.z = e.z;
+    s.yaw = e.yaw;
+    s.pitch = e.pitch;
+    s.vx = e.vx; s.vy = e.vy; s.vz = e.vz;
+    return s;
+}
+
+// Binary search in a list sorted by player_id
+const EntityState* find_entity(const EntityState* list, size_t count,
+                               uint32_t player_id);
+
+// Encodes `current` against `baseline` (both sorted by player_id) into
+// MTU-sized parts. Pass baseline_tick = 0 for a keyframe. Reuses the
+// storage in `out`; returns the number of parts written. If the part
+// limit is hit, only a prefix of `current` goes out; its length is
+// stored in entities_written.
+size_t encode_world_snapshot(uint32_t tick, uint8_t tick_rate,
+                             const EntityState* current, size_t count,
+                             uint32_t baseline_tick,
+                             const EntityState* baseline, size_t baseline_count,
+                             std::vector<WorldPacket>& out,
+                             size_t* entities_written = nullptr,
+                             const SnapshotQuantization& q =
+                                 DEFAULT_SNAPSHOT_QUANTIZATION);
+
+// Bits one record for `e` takes against `base` (nullptr: full record),
+// assuming a full player_id. Lets the server budget before encoding.
+size_t world_record_bits(const EntityState& e, const EntityState* base,
+                         const SnapshotQuantization& q =
+                             DEFAULT_SNAPSHOT_QUANTIZATION);
+
+// Upper bound on the datagram bytes (headers included) that
+// encode_world_snapshot needs for records totalling record_bits.
+size_t world_snapshot_max_bytes(size_t record_bits,
+                                const SnapshotQuantization& q =
+                                    DEFAULT_SNAPSHOT_QUANTIZATION);
+
+// Validates the fixed header of a received datagram.
+bool read_world_snapshot_header(const uint8_t* data, size_t size,
+                                WorldSnapshotHeader& out);
+
+// Decodes the records of one part, appending dequantized entities to
+// `out`. Fails if the records do not consume the datagram exactly or
+// reference an entity missing from the baseline.
+bool decode_world_snapshot(const uint8_t* data, size_t size,
+                           const WorldSnapshotHeader& hdr,
+                           const EntityState* baseline, size_t baseline_count,
+                           std::vector<EntityState>& out,
+                           const SnapshotQuantization& q =
+                               DEFAULT_SNAPSHOT_QUANTIZATION);
@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "sentinel/net/buffer/packet_pool.hpp"
+#include "sentinel/net/protocol/reliable.hpp"
+
+// ------------------------------------------------------------
+// Reliable ordered channel
+// ------------------------------------------------------------
+// One end of a connection's reliable stream. Everything is fixed
+// size: at most RELIABLE_WINDOW messages are unacked on the way out
+// or waiting for a gap on the way in, so memory per connection is
+// bounded (about 10 KB) and send() refuses once the peer falls that
+// far behind.
+//
+// Unacked messages go out again when they have waited longer than the
+// resend timeout, which follows the RTT measured from acked packets.
+// Acks cost no packets of their own: the owner copies acks() into the
+// packets it sends every tick and feeds the peer's into on_ack().
+//
+// The PacketRef overloads keep views instead of copies: a message
+// queued that way is shared with every other channel it was queued on,
+// and one received that way stays in the datagram it arrived in.
+
+constexpr uint16_t RELIABLE_WINDOW = 32; // messages, power of two
+
+struct ReliableStats {
+    uint64_t resent  = 0; // messages sent again after a timeout
+    uint64_t dropped = 0; // messages refused with the window full
+};
+
+class ReliableChannel {
+public:
+    // Queues one message (a whole packet struct); false if it is too
+    // large or the window is full
+    bool send(const void* data, size_t size, ReliableStats& stats);
+    bool send(const PacketRef& msg, ReliableStats& stats);
+
+    // Builds a RELIABLE packet of the messages that are new or due for
+    // a resend. Returns its size, or 0 when nothing is due.
+    size_t write(uint8_t* out, size_t capacity, double now,
+                 ReliableStats& stats);
+
+    // A RELIABLE packet from the peer; false if it is malformed
+    bool receive(const uint8_t* data, size_t size, double now);
+    bool receive(const PacketRef& packet, double now);
+
+    // Next message in order. The bytes stay valid until the next
+    // receive(); the view, for as long as it is held. A message that
+    // came through the copying receive() pops as an empty view.
+    bool pop(const uint8_t*& data, size_t& size);
+    bool pop(PacketRef& msg);
+
+    // What to tell the peer, and what the peer told us
+    ReliableAck acks() const;
+    void        on_ack(const ReliableAck& acks, double now);
+
+    // Smoothed round trip, seconds; 0 until the first ack
+    double rtt() const { return srtt; }
+
+    bool idle() const { return out_oldest == out_next; }
+
+private:
+    static constexpr uint16_t SENT_HISTORY = 64; // packets, power of two
+
+    struct Outgoing {
+        uint16_t id = 0;
+        uint16_t size = 0;
+        bool     live = false;     // queued and not yet acked
+        double   sent_at = -1.0;   // < 0 = never sent
+        PacketRef ref;             // the message, if not in bytes
+        uint8_t  bytes[RELIABLE_MAX_MESSAGE];
+
+        const uint8_t* data() const { return ref ? ref.data() : bytes; }
+    };
+
+    struct Sent {
+        uint16_t seq = 0;
+        bool     live = false;
+        double   time = 0.0;
+        uint16_t base = 0; // message id of bit 0 in `mask`
+        uint32_t mask = 0;
+    };
+
+    struct Incoming {
+        uint16_t id = 0;
+        uint16_t size = 0;
+        bool     present = false;
+        PacketRef ref;             // the message, if not in bytes
+        uint8_t  bytes[RELIABLE_MAX_MESSAGE];
+
+        const uint8_t* data() const { return ref ? ref.data() : bytes; }
+    };
+
+    double resend_timeout() const;
+    bool   queue(const void* data, const PacketRef* msg, size_t size,
+                 ReliableStats& stats);
+    bool   take(const uint8_t* data, size_t size, const PacketRef* packet,
+                double now);
+
+    // ---- outgoing ----
+    Outgoing out[RELIABLE_WINDOW];
+    Sent     sent[SENT_HISTORY];
+    uint16_t out_next   = 0; // id of the next send()
+    uint16_t out_oldest = 0; // oldest unacked id
+    uint16_t out_seq    = 0; // sequence of the next packet
+    double   srtt = 0.0;
+    double   rttvar = 0.0;
+
+    // ---- incoming ----
+    Incoming in[RELIABLE_WINDOW];
+    uint16_t in_next = 0;    // id delivered next
+    uint16_t in_seq  = 0;    // newest packet received
+    uint32_t in_bits = 0;    // bit i = packet in_seq - i received
+};
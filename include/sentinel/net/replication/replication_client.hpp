@@ -1,13 +1,59 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 #include "sentinel/net/replication/snapshot_buffer.hpp"
 
 class ReplicationClient {
 public:
     void ingest(const Snapshot& s);
+
+    // Accepts a raw WORLD_SNAPSHOT datagram that arrived at local time
+    // `now` (seconds, any epoch). Returns false if the bytes are not a
+    // world snapshot. Parts whose baseline is unknown are dropped; the
+    // server falls back to a keyframe once acks stall.
+    bool ingest(const uint8_t* data, size_t size, double now);
+
+    // Newest fully received world tick not yet reported to the server
+    bool take_ack(uint32_t& tick);
+
+    // Server time to sample at local time `now`: the newest tick's time,
+    // run forward by the local time since it arrived, less `delay`.
+    // Snapshots carry tick / tick_rate, so the client's own clock
+    // cannot be compared with them directly. Negative before any world.
+    double render_time(double now, double delay) const;
+
     bool sample(uint32_t player_id, double render_time,
                 Snapshot& a, Snapshot& b);
 
+    // Every player id seen so far (ids are sparse, not 1..N)
+    void player_ids(std::vector<uint32_t>& out) const;
+
+    // Server simulation rate, 0 until a world snapshot arrives
+    uint8_t tick_rate() const { return rate; }
+
 private:
+    // Reconstructed world per tick; complete frames are delta baselines
+    struct WorldFrame {
+        uint32_t tick = 0;
+        uint32_t baseline_tick = 0;
+        uint8_t  part_count = 0;
+        uint64_t parts_seen = 0;
+        bool     complete = false;
+        std::vector<EntityState> entities; // sorted once complete
+    };
+
+    static constexpr size_t FRAME_HISTORY = 64;
+
+    const WorldFrame* complete_frame(uint32_t tick) const;
+
     std::unordered_map<uint32_t, SnapshotBuffer> players;
+
+    WorldFrame frames[FRAME_HISTORY];
+    uint32_t newest_complete = 0;
+    uint32_t last_acked = 0;
+    uint32_t newest_tick = 0;      // any part seen
+    double   newest_arrival = 0.0; // local time it came in
+    uint8_t  rate = 0;
 };
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <deque>
 #include "sentinel/net/protocol/snapshot.hpp"
 
@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sentinel/net/transport/udp_socket.hpp"
+
+// ------------------------------------------------------------
+// Simulated network
+// ------------------------------------------------------------
+// Any number of UdpSockets joined in memory. Nothing moves by itself:
+// time is a virtual clock the owner advances, and a datagram sent over
+// a link arrives once the clock reaches its delivery time. A scenario
+// therefore runs as fast as its code does, and the same seed and the
+// same calls give the same deliveries, down to every loss and
+// duplicate.
+//
+// Every direction between two endpoints is a link with its own
+// SimLinkConfig; links not set explicitly use the default. A datagram
+// on a link is, in order:
+//
+//   lost         with probability `loss`
+//   queued       behind earlier ones at `bandwidth` bytes/s, dropped
+//                when it would take the wait past `queue_bytes`
+//   delayed      by `latency` plus a jitter draw
+//   held back    by `reorder_delay` more with probability `reorder`,
+//                letting later datagrams overtake it
+//   duplicated   with probability `duplicate`; the copy draws its own
+//                delay
+//
+// Jitter never reorders by itself: deliveries on a link stay in send
+// order unless a datagram is held back.
+//
+// Sockets never block. recv_from() returns -1 when nothing has
+// arrived, like a non-blocking socket, and the batched calls work as
+// they do on the real backends.
+//
+// Single-threaded: the network and its sockets belong to one thread,
+// and every socket must be closed before the network goes.
+
+enum class SimJitter : uint8_t {
+    UNIFORM, // 0 .. jitter
+    NORMAL,  // |N(0, jitter)|
+    PARETO,  // heavy tail with scale `jitter`: mostly small, rare spikes
+};
+
+struct SimLinkConfig {
+    double    latency = 0.0; // seconds, one way
+    double    jitter  = 0.0; // seconds, added on top of latency
+    SimJitter jitter_shape = SimJitter::UNIFORM;
+
+    double loss      = 0.0; // probabilities, 0..1
+    double duplicate = 0.0;
+    double reorder   = 0.0;
+    double reorder_delay = 0.010; // seconds a reordered datagram waits
+
+    double bandwidth   = 0.0;     // bytes/s; 0 = unlimited
+    size_t queue_bytes = 65536;   // waiting behind the bandwidth cap
+};
+
+struct SimLinkStats {
+    uint64_t sent       = 0;
+    uint64_t delivered  = 0;
+    uint64_t lost       = 0;
+    uint64_t queue_drop = 0; // over queue_bytes
+    uint64_t recv_drop  = 0; // no socket there, or its queue was full
+    uint64_t duplicated = 0;
+    uint64_t reordered  = 0;
+    uint64_t bytes      = 0; // delivered
+};
+
+class SimNetwork {
+public:
+    explicit SimNetwork(uint64_t seed = 1);
+    ~SimNetwork();
+
+    SimNetwork(const SimNetwork&) = delete;
+    SimNetwork& operator=(const SimNetwork&) = delete;
+
+    // A socket bound to host:port, as UdpSocket::create() would make;
+    // port 0 picks a free one. nullptr if the address is taken or the
+    // host does not parse. The caller owns it.
+    UdpSocket* create(const char* host, uint16_t port);
+
+    // Where a socket made here is bound
+    static sockaddr_in address(const UdpSocket* socket);
+
+    void set_default_link(const SimLinkConfig& config);
+    void set_link(const sockaddr_in& from, const sockaddr_in& to,
+                  const SimLinkConfig& config);
+
+    // Both directions between a and b
+    void set_path(const sockaddr_in& a, const sockaddr_in& b,
+                  const SimLinkConfig& config);
+
+    // ---- virtual clock ----
+    double now() const { return clock; }
+
+    // Moves the clock forward and delivers everything due by then
+    void advance(double seconds);
+    void advance_to(double time);
+
+    // When the next datagram arrives; a negative time when none is in
+    // flight. Lets a harness jump straight over idle time.
+    double next_delivery() const;
+
+    size_t in_flight() const { return flight.size(); }
+
+    SimLinkStats link_stats(const sockaddr_in& from,
+                            const sockaddr_in& to) const;
+    SimLinkStats stats() const; // every link summed
+
+private:
+    class Endpoint;
+
+    struct Link {
+        SimLinkConfig config;
+        SimLinkStats  stats;
+        double        busy_until   = 0.0; // bandwidth queue drains then
+        double        last_arrival = 0.0; // keeps jitter from reordering
+    };
+
+    struct Datagram {
+        double               at  = 0.0;
+        uint64_t             seq = 0; // send order breaks ties
+        uint64_t             from = 0;
+        uint64_t             to   = 0;
+        std::vector<uint8_t> bytes;
+    };
+
+    struct Later {
+        bool operator()(const Datagram& a, const Datagram& b) const {
+            return a.at != b.at ? a.at > b.at : a.seq > b.seq;
+        }
+    };
+
+    using LinkKey = std::pair<uint64_t, uint64_t>;
+
+    static uint64_t key(const sockaddr_in& a);
+    static sockaddr_in from_key(uint64_t k);
+
+    void   send(uint64_t from, uint64_t to, const void* data, size_t size);
+    Link&  link(uint64_t from, uint64_t to);
+    double delay(const SimLinkConfig& config);
+    void   close(uint64_t address);
+
+    // splitmix64; the same stream on every platform, unlike <random>'s
+    // distributions
+    uint64_t next_random();
+    double   uniform(); // [0, 1)
+
+    uint64_t rng;
+    double   clock = 0.0;
+    uint64_t sends = 0;
+    uint16_t next_port = 49152;
+
+    SimLinkConfig default_link;
+    std::map<LinkKey, Link> links;
+
+    std::unordered_map<uint64_t, Endpoint*> endpoints;
+    std::priority_queue<Datagram, std::vector<Datagram>, Later> flight;
+};
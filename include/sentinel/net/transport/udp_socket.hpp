@@ -1,6 +1,8 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <span>
 
 #if defined(_WIN32)
     #include <winsock2.h>
@@ -12,6 +14,38 @@
     #include <arpa/inet.h>
 #endif
 
+// Which implementation UdpSocket::create() builds. IO_URING is Linux
+// only; anywhere it cannot start, create() falls back to SYSCALL.
+enum class UdpBackend : uint8_t {
+    SYSCALL,  // one sendto / recvfrom per datagram
+    IO_URING, // multishot recvmsg into provided buffers, batched sendmsg
+};
+
+// "syscall" or "io_uring"; false for anything else
+inline bool udp_backend_from_name(const char* name, UdpBackend& out) {
+    if (std::strcmp(name, "syscall") == 0)
+        out = UdpBackend::SYSCALL;
+    else if (std::strcmp(name, "io_uring") == 0)
+        out = UdpBackend::IO_URING;
+    else
+        return false;
+    return true;
+}
+
+// One datagram of a send_batch() / recv_batch() call
+struct OutPacket {
+    const void* data = nullptr;
+    size_t      size = 0;
+    sockaddr_in to{};
+};
+
+struct InPacket {
+    void*       data = nullptr; // the caller's buffer
+    size_t      capacity = 0;
+    size_t      size = 0;       // set by recv_batch()
+    sockaddr_in from{};         // likewise
+};
+
 class UdpSocket {
 public:
     virtual ~UdpSocket() = default;
@@ -22,5 +56,34 @@ public:
     virtual ssize_t send_to(const void* data, size_t size, const sockaddr_in& to) = 0;
     virtual ssize_t recv_from(void* out, size_t max, sockaddr_in& from) = 0;
 
-    static UdpSocket* create(const char* host, uint16_t port);
+    // Sends in order and returns how many went out; stops at the first
+    // failure (-1 if that is the first packet)
+    virtual int send_batch(std::span<const OutPacket> packets) {
+        int sent = 0;
+        for (const OutPacket& p : packets) {
+            if (send_to(p.data, p.size, p.to) < 0)
+                return sent ? sent : -1;
+            ++sent;
+        }
+        return sent;
+    }
+
+    // Fills packets from the front with datagrams that have already
+    // arrived; never waits. Returns how many (0 if none), -1 on error.
+    // This fallback loops recv_from(), so it needs a non-blocking
+    // socket; the Linux backends override it.
+    virtual int recv_batch(std::span<InPacket> packets) {
+        int got = 0;
+        for (InPacket& p : packets) {
+            ssize_t n = recv_from(p.data, p.capacity, p.from);
+            if (n <= 0)
+                break;
+            p.size = size_t(n);
+            ++got;
+        }
+        return got;
+    }
+
+    static UdpSocket* create(const char* host, uint16_t port,
+                             UdpBackend backend = UdpBackend::SYSCALL);
 };
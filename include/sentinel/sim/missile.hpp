@@ -0,0 +1,6 @@
+#pragma once
+
+// Missile tuning, shared by the client and the server's hit checks
+constexpr float MISSILE_SPEED = 28.0f;
+constexpr float MISSILE_LIFE = 4.0f;   // seconds
+constexpr float EXPLOSION_MAX_RADIUS = 6.0f;
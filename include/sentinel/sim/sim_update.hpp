@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 
 struct SimWorld {
     float time = 0.0f;
@@ -13,12 +14,31 @@ struct SimPlayer {
     float pitch = 0.0f;
 };
 
+// One tick of stick input; every axis in [-1, 1]
+struct SimInput {
+    float throttle = 0.0f;
+    float strafe   = 0.0f;
+    float vertical = 0.0f;
+    float yaw      = 0.0f;
+    float pitch    = 0.0f;
+    bool  boost    = false;
+};
+
+// The one flight model: the server steps players with it and the
+// client predicts with it, so both must run exactly this code.
 void sim_update(
     SimWorld& world,
     SimPlayer& player,
-    float dt,
-    float throttle,
-    float strafe,
-    float yaw,
-    float pitch
+    const SimInput& input,
+    float dt
+);
+
+// Steps players[0..count) by one tick, each with inputs[i]. Same
+// integration as sim_update; world time advances once for the batch.
+void sim_update_batch(
+    SimWorld& world,
+    SimPlayer* players,
+    const SimInput* inputs,
+    size_t count,
+    float dt
 );
@@ -0,0 +1,594 @@
+// Headless load generator: thousands of bots against a server on the
+// same host. Each bot does the HELLO handshake, sends an InputCmd per
+// tick (flying its own copy with sim_update to steer), decodes and acks
+// world snapshots, and measures how late each world tick arrives.
+//
+//   loadgen [--bots N] [--threads T] [--rate HZ] [--duration S]
+//           [--ramp S] [--area R] [--fire PER_S] [--host IP] [--port P]
+//
+// --fire launches that many missiles per second from each bot, to load
+// the server's projectile simulation.
+//
+// --rate should match the server's --tick-rate: the server plays one
+// command per tick, so a faster stream only fills its input buffers.
+//
+// Latency is receipt time minus the tick's scheduled time on the
+// server. Both sides read CLOCK_MONOTONIC, so it is exact on one host.
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "sentinel/net/protocol/bundle.hpp"
+#include "sentinel/net/protocol/world_snapshot.hpp"
+#include "sentinel/net/replication/replication_client.hpp"
+#include "sentinel/net/reliable/reliable_channel.hpp"
+#include "sentinel/sim/missile.hpp"
+#include "sentinel/sim/sim_update.hpp"
+
+#include "metrics.hpp"
+
+struct LoadgenConfig {
+    size_t      bots     = 1000;
+    size_t      threads  = 1;
+    int         rate     = 30;   // input commands per second per bot
+    double      duration = 30.0; // measured seconds, after the ramp
+    double      ramp     = 2.0;  // bots join spread over this long
+    float       area     = 400.0f; // bots turn home beyond this radius
+    float       fire     = 0.0f; // missiles per second per bot
+    std::string host     = "127.0.0.1";
+    uint16_t    port     = 7777;
+};
+
+static uint64_t monotonic_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+// ------------------------------------------------------------
+// Bot
+// ------------------------------------------------------------
+struct Bot {
+    int      fd = -1;
+    uint32_t id = 0;
+
+    uint64_t join_at    = 0; // ns
+    uint64_t next_hello = 0;
+
+    SimWorld  world;
+    SimPlayer player;
+    float     throttle = 0.0f, strafe = 0.0f, turn = 0.0f;
+    uint64_t  next_steer = 0;
+    uint32_t  seq = 0;
+
+    float    fire_credit = 0.0f;
+    uint32_t missile_id  = 0;
+
+    ReliableChannel reliable; // missile events, and the server's to us
+
+    ReplicationClient replication;
+
+    // welcome: scheduled time of one server tick
+    uint32_t welcome_tick = 0;
+    double   welcome_time = 0.0;
+
+    // world ticks, counted once the next tick starts arriving
+    uint32_t cur_tick  = 0;
+    uint32_t cur_parts = 0;
+    uint32_t cur_count = 0;
+    uint32_t first_tick = 0;
+};
+
+// Written by one thread, read by main for progress lines
+struct ThreadStats {
+    Counter joined;
+    Counter datagrams_in;
+    Counter bytes_in;
+    Counter datagrams_out;
+    Counter ticks_seen;
+    Counter ticks_expected;
+    Counter parts_seen;
+    Counter parts_expected;
+    Counter reliable_in;   // server events delivered
+    Counter reliable_lost; // missile events refused, window full
+
+    LatencyHistogram latency_ns;
+};
+
+class BotThread {
+public:
+    BotThread(const LoadgenConfig& c, size_t first, size_t count,
+              uint64_t start_ns, uint64_t measure_ns, uint64_t end_ns)
+        : config(c), bots(count), measure_from(measure_ns), end(end_ns),
+          rng(uint32_t(first * 7919 + 1)) {
+        server.sin_family = AF_INET;
+        server.sin_port   = htons(config.port);
+        inet_pton(AF_INET, config.host.c_str(), &server.sin_addr);
+
+        for (size_t i = 0; i < count; ++i) {
+            double t = config.ramp * double(first + i) / double(config.bots);
+            bots[i].join_at = start_ns + uint64_t(t * 1e9);
+        }
+    }
+
+    ~BotThread() {
+        for (Bot& b : bots) {
+            if (b.fd >= 0)
+                close(b.fd);
+        }
+        if (timerfd >= 0) close(timerfd);
+        if (epfd >= 0)    close(epfd);
+    }
+
+    bool open();
+    void run();
+
+    ThreadStats stats;
+
+private:
+    void join(Bot& b);
+    void step(Bot& b, float dt, uint64_t now);
+    void drain(Bot& b, uint64_t now);
+    void handle(Bot& b, const uint8_t* packet, size_t size, uint64_t now,
+                bool measuring);
+    void count_world(Bot& b, const WorldSnapshotHeader& hdr, uint64_t now);
+
+    void send(Bot& b, const void* data, size_t size) {
+        if (sendto(b.fd, data, size, 0, (const sockaddr*)&server,
+                   sizeof(server)) == ssize_t(size))
+            stats.datagrams_out.add();
+    }
+
+    const LoadgenConfig& config;
+    std::vector<Bot>     bots;
+    sockaddr_in          server{};
+
+    uint64_t measure_from;
+    uint64_t end;
+
+    int epfd    = -1;
+    int timerfd = -1;
+
+    std::mt19937  rng;
+    ReliableStats reliable_stats;
+};
+
+bool BotThread::open() {
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epfd < 0 || timerfd < 0) {
+        perror("loadgen epoll/timerfd");
+        return false;
+    }
+
+    long period = 1000000000L / config.rate;
+    itimerspec its{};
+    its.it_interval.tv_sec  = period / 1000000000L;
+    its.it_interval.tv_nsec = period % 1000000000L;
+    its.it_value = its.it_interval;
+    timerfd_settime(timerfd, 0, &its, nullptr);
+
+    epoll_event ev{};
+    ev.events   = EPOLLIN;
+    ev.data.u64 = ~uint64_t(0);
+    epoll_ctl(epfd, EPOLL_CTL_ADD, timerfd, &ev);
+
+    for (size_t i = 0; i < bots.size(); ++i) {
+        Bot& b = bots[i];
+        b.fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (b.fd < 0) {
+            perror("loadgen socket");
+            return false;
+        }
+
+        // World packets for thousands of bots queue up between polls
+        int rcvbuf = 1 << 20;
+        setsockopt(b.fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        ev.events   = EPOLLIN;
+        ev.data.u64 = i;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, b.fd, &ev) < 0) {
+            perror("loadgen epoll_ctl");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void BotThread::join(Bot& b) {
+    // The server picks the spawn; it comes back in the welcome
+    Hello hello{};
+    send(b, &hello, sizeof(hello));
+}
+
+void BotThread::step(Bot& b, float dt, uint64_t now) {
+    // New stick input every couple of seconds
+    if (now >= b.next_steer) {
+        std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+        b.throttle = 0.5f + 0.5f * u(rng);
+        b.strafe   = 0.3f * u(rng);
+        b.turn     = 0.5f * u(rng);
+        b.next_steer = now + 2000000000ull + uint64_t(u(rng) * 1e9);
+    }
+
+    // Turn back toward the origin once outside the area
+    float turn = b.turn;
+    float r2 = b.player.x * b.player.x + b.player.z * b.player.z;
+    if (r2 > config.area * config.area) {
+        float home = std::atan2(-b.player.z, -b.player.x);
+        float off  = std::remainder(home - b.player.yaw, 6.28318531f);
+        turn = std::clamp(2.0f * off, -1.0f, 1.0f);
+    }
+
+    SimInput in;
+    in.throttle = b.throttle;
+    in.strafe   = b.strafe;
+    in.yaw      = turn;
+
+    // Same step the server will take with this command
+    sim_update(b.world, b.player, in, dt);
+
+    InputCmd cmd{};
+    cmd.player_id = b.id;
+    cmd.tick      = ++b.seq;
+    cmd.throttle  = in.throttle;
+    cmd.strafe    = in.strafe;
+    cmd.yaw       = in.yaw;
+    cmd.acks      = b.reliable.acks();
+    send(b, &cmd, sizeof(cmd));
+
+    // Straight ahead from the nose, like the client
+    for (b.fire_credit += config.fire * dt; b.fire_credit >= 1.0f;
+         b.fire_credit -= 1.0f) {
+        const float fx = std::cos(b.player.yaw), fz = std::sin(b.player.yaw);
+
+        MissileFireEvent ev{};
+        ev.owner_id   = b.id;
+        ev.missile_id = ++b.missile_id;
+        ev.x  = b.player.x + fx * 1.4f;
+        ev.y  = b.player.y;
+        ev.z  = b.player.z + fz * 1.4f;
+        ev.vx = fx * MISSILE_SPEED;
+        ev.vz = fz * MISSILE_SPEED;
+        if (!b.reliable.send(&ev, sizeof(ev), reliable_stats))
+            stats.reliable_lost.add();
+    }
+
+    uint8_t out[RELIABLE_MTU];
+    if (size_t n = b.reliable.write(out, sizeof(out), double(now) * 1e-9,
+                                    reliable_stats))
+        send(b, out, n);
+}
+
+void BotThread::count_world(Bot& b, const WorldSnapshotHeader& hdr,
+                            uint64_t now) {
+    if (hdr.tick != b.cur_tick) {
+        if (hdr.tick < b.cur_tick)
+            return; // late straggler
+
+        // Close out the previous tick; ticks with no parts at all
+        // count as one lost part each
+        if (b.cur_tick != 0) {
+            stats.parts_seen.add(b.cur_parts);
+            stats.parts_expected.add(b.cur_count);
+            stats.ticks_seen.add();
+            stats.ticks_expected.add(hdr.tick - b.cur_tick);
+            stats.parts_expected.add(hdr.tick - b.cur_tick - 1);
+        }
+
+        b.cur_tick  = hdr.tick;
+        b.cur_parts = 0;
+        b.cur_count = hdr.part_count;
+
+        // First part of a tick: how late is it?
+        if (b.welcome_time > 0.0) {
+            double period = 1.0 / double(hdr.tick_rate);
+            double sched = b.welcome_time +
+                           double(int64_t(hdr.tick) - int64_t(b.welcome_tick)) * period;
+            double late = double(now) * 1e-9 - sched;
+            if (late > 0.0)
+                stats.latency_ns.record(uint64_t(late * 1e9));
+        }
+    }
+
+    b.cur_parts += 1;
+}
+
+void BotThread::drain(Bot& b, uint64_t now) {
+    uint8_t packet[BUNDLE_MTU];
+    const bool measuring = now >= measure_from;
+
+    while (true) {
+        sockaddr_in from{};
+        socklen_t len = sizeof(from);
+        ssize_t n = recvfrom(b.fd, packet, sizeof(packet), 0,
+                             (sockaddr*)&from, &len);
+        if (n <= 0)
+            break;
+
+        if (measuring) {
+            stats.datagrams_in.add();
+            stats.bytes_in.add(uint64_t(n));
+        }
+
+        // A bundle holds the server's whole tick for this bot
+        PacketHeader head{};
+        if (size_t(n) >= sizeof(head))
+            std::memcpy(&head, packet, sizeof(head));
+
+        if (head.version == PROTOCOL_VERSION &&
+            head.type == PacketType::BUNDLE) {
+            read_bundle(packet, size_t(n),
+                        [&](const uint8_t* data, size_t size) {
+                            handle(b, data, size, now, measuring);
+                        });
+        } else {
+            handle(b, packet, size_t(n), now, measuring);
+        }
+    }
+
+    uint32_t ack_tick = 0;
+    if (b.replication.take_ack(ack_tick)) {
+        SnapshotAck ack{};
+        ack.tick = ack_tick;
+        send(b, &ack, sizeof(ack));
+    }
+}
+
+void BotThread::handle(Bot& b, const uint8_t* packet, size_t n,
+                       uint64_t now, bool measuring) {
+    if (n < sizeof(PacketHeader))
+        return;
+
+    PacketHeader type{};
+    std::memcpy(&type, packet, sizeof(type));
+    if (type.version != PROTOCOL_VERSION)
+        return;
+
+    // Server events: take them so the window keeps moving
+    if (type.type == PacketType::RELIABLE) {
+        if (b.reliable.receive(packet, n, double(now) * 1e-9)) {
+            const uint8_t* msg;
+            size_t         len;
+            while (b.reliable.pop(msg, len))
+                stats.reliable_in.add();
+        }
+        return;
+    }
+
+    if (n == sizeof(PlayerState) && type.type == PacketType::PLAYER_STATE) {
+        PlayerState st{};
+        std::memcpy(&st, packet, sizeof(st));
+        b.reliable.on_ack(st.acks, double(now) * 1e-9);
+        return;
+    }
+
+    WorldSnapshotHeader hdr{};
+    if (read_world_snapshot_header(packet, n, hdr)) {
+        if (measuring)
+            count_world(b, hdr, now);
+        b.replication.ingest(packet, n, double(now) * 1e-9);
+        return;
+    }
+
+    if (n == sizeof(Snapshot) && type.type == PacketType::SNAPSHOT &&
+        b.id == 0) {
+        Snapshot welcome{};
+        std::memcpy(&welcome, packet, sizeof(welcome));
+
+        b.id = welcome.player_id;
+        b.player.x   = welcome.x;
+        b.player.y   = welcome.y;
+        b.player.z   = welcome.z;
+        b.player.yaw = welcome.yaw;
+        b.welcome_tick = welcome.tick;
+        b.welcome_time = welcome.sched_time;
+        stats.joined.add();
+    }
+}
+
+void BotThread::run() {
+    const float dt = 1.0f / float(config.rate);
+    std::vector<epoll_event> events(256);
+
+    size_t next_join = 0;
+
+    while (true) {
+        uint64_t now = monotonic_ns();
+        if (now >= end)
+            break;
+
+        // Bots join in order, spread across the ramp
+        while (next_join < bots.size() && bots[next_join].join_at <= now) {
+            Bot& b = bots[next_join];
+            join(b);
+            b.next_hello = now + 1000000000ull;
+            ++next_join;
+        }
+
+        int n = epoll_wait(epfd, events.data(), int(events.size()), 5);
+        now = monotonic_ns();
+
+        for (int i = 0; i < n; ++i) {
+            uint64_t tag = events[i].data.u64;
+
+            if (tag != ~uint64_t(0)) {
+                drain(bots[tag], now);
+                continue;
+            }
+
+            uint64_t expirations = 0;
+            if (read(timerfd, &expirations, sizeof(expirations)) !=
+                sizeof(expirations))
+                continue;
+
+            for (size_t k = 0; k < next_join; ++k) {
+                Bot& b = bots[k];
+
+                if (b.id != 0) {
+                    step(b, dt, now);
+                } else if (now >= b.next_hello) {
+                    // HELLO is unreliable; repeat until welcomed
+                    Hello hello{};
+                    send(b, &hello, sizeof(hello));
+                    b.next_hello = now + 1000000000ull;
+                }
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// Main
+// ------------------------------------------------------------
+static void raise_fd_limit() {
+    rlimit lim{};
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < lim.rlim_max) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+int main(int argc, char** argv) {
+    LoadgenConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--bots") == 0 && i + 1 < argc)
+            config.bots = size_t(atol(argv[++i]));
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            config.threads = size_t(atol(argv[++i]));
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+            config.rate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
+            config.duration = atof(argv[++i]);
+        else if (strcmp(argv[i], "--ramp") == 0 && i + 1 < argc)
+            config.ramp = atof(argv[++i]);
+        else if (strcmp(argv[i], "--area") == 0 && i + 1 < argc)
+            config.area = float(atof(argv[++i]));
+        else if (strcmp(argv[i], "--fire") == 0 && i + 1 < argc)
+            config.fire = float(atof(argv[++i]));
+        else if (strcmp(argv[i], "--host") == 0 && i + 1 < argc)
+            config.host = argv[++i];
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            config.port = uint16_t(atoi(argv[++i]));
+    }
+
+    if (config.bots == 0 || config.threads == 0 ||
+        config.threads > config.bots || config.rate < 1 ||
+        config.rate > 1000 || config.duration <= 0.0 || config.fire < 0.0f) {
+        fprintf(stderr, "[loadgen] bad arguments\n");
+        return 1;
+    }
+
+    raise_fd_limit();
+
+    const uint64_t start   = monotonic_ns();
+    const uint64_t measure = start + uint64_t((config.ramp + 1.0) * 1e9);
+    const uint64_t end     = measure + uint64_t(config.duration * 1e9);
+
+    std::vector<std::unique_ptr<BotThread>> workers;
+    size_t first = 0;
+    for (size_t t = 0; t < config.threads; ++t) {
+        size_t count = config.bots / config.threads +
+                       (t < config.bots % config.threads ? 1 : 0);
+
+        workers.push_back(std::make_unique<BotThread>(
+            config, first, count, start, measure, end));
+        if (!workers.back()->open())
+            return 1;
+
+        first += count;
+    }
+
+    printf("[loadgen] %zu bots on %zu thread(s) -> %s:%u, %d Hz input, "
+           "%.0f s ramp + %.0f s measured\n",
+        config.bots, config.threads, config.host.c_str(), config.port,
+        config.rate, config.ramp, config.duration);
+
+    std::vector<std::thread> threads;
+    for (auto& w : workers)
+        threads.emplace_back([&w] { w->run(); });
+
+    // Progress once a second
+    uint64_t last_in = 0;
+    while (monotonic_ns() + 1000000000ull < end) {
+        sleep(1);
+
+        uint64_t joined = 0, in = 0;
+        for (auto& w : workers) {
+            joined += w->stats.joined.get();
+            in     += w->stats.datagrams_in.get();
+        }
+
+        printf("[loadgen] %llu/%zu joined, %llu datagrams/s in\n",
+            (unsigned long long)joined, config.bots,
+            (unsigned long long)(in - last_in));
+        last_in = in;
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    // ---- summary ----
+    HistogramCounts latency;
+    uint64_t joined = 0, in = 0, bytes = 0, out = 0;
+    uint64_t ticks = 0, ticks_expected = 0, parts = 0, parts_expected = 0;
+    uint64_t events = 0, events_lost = 0;
+
+    for (auto& w : workers) {
+        const ThreadStats& s = w->stats;
+        s.latency_ns.add_to(latency);
+        joined         += s.joined.get();
+        in             += s.datagrams_in.get();
+        bytes          += s.bytes_in.get();
+        out            += s.datagrams_out.get();
+        ticks          += s.ticks_seen.get();
+        ticks_expected += s.ticks_expected.get();
+        parts          += s.parts_seen.get();
+        parts_expected += s.parts_expected.get();
+        events         += s.reliable_in.get();
+        events_lost    += s.reliable_lost.get();
+    }
+
+    auto loss = [](uint64_t got, uint64_t expected) {
+        return expected ? 100.0 * (1.0 - double(got) / double(expected)) : 0.0;
+    };
+
+    printf("[loadgen] %llu/%zu bots joined, %llu datagrams out, %llu in\n",
+        (unsigned long long)joined, config.bots,
+        (unsigned long long)out, (unsigned long long)in);
+    printf("[loadgen] world latency p50 %.2f ms, p99 %.2f ms, "
+           "p999 %.2f ms, max %.2f ms\n",
+        double(latency.percentile(0.5)) * 1e-6,
+        double(latency.percentile(0.99)) * 1e-6,
+        double(latency.percentile(0.999)) * 1e-6,
+        double(latency.max) * 1e-6);
+    printf("[loadgen] tick loss %.3f%%, part loss %.3f%%\n",
+        loss(ticks, ticks_expected), loss(parts, parts_expected));
+    printf("[loadgen] %.0f bytes/s per client\n",
+        double(bytes) / config.duration / double(joined ? joined : 1));
+    if (config.fire > 0.0f)
+        printf("[loadgen] %llu server events received, %llu shots refused "
+               "with the reliable window full\n",
+            (unsigned long long)events, (unsigned long long)events_lost);
+
+    return 0;
+}
@@ -0,0 +1,443 @@
+// Simulated network benchmark: real server workers and N bots over
+// SimNetwork links, in virtual time. The workers run exactly as they do
+// live (ingest, input buffering, world build and coalescing, reliable
+// events, eviction); only their socket and clock are simulated, so a
+// scenario with loss, jitter or a bandwidth cap runs faster than real
+// time and the same way every time.
+//
+//   net_sim_bench [--bots N] [--workers W] [--seconds S]
+//                 [--tick-rate 20|30|60] [--fire PER_S]
+//                 [--latency MS] [--jitter MS]
+//                 [--shape uniform|normal|pareto] [--loss P]
+//                 [--duplicate P] [--reorder P] [--bandwidth KB/S]
+//                 [--seed X]
+//
+// Each step of 1 / tick-rate virtual seconds, every bot reads what
+// arrived and sends an input command (hello until welcomed), the clock
+// advances, and every worker polls its socket and ticks. Bots behave
+// like loadgen's: they wander, fire missiles and ack what they get.
+// Same options and seed, same output.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "sentinel/net/protocol/bundle.hpp"
+#include "sentinel/net/protocol/world_snapshot.hpp"
+#include "sentinel/net/replication/replication_client.hpp"
+#include "sentinel/net/reliable/reliable_channel.hpp"
+#include "sentinel/net/transport/sim_network.hpp"
+#include "sentinel/sim/missile.hpp"
+#include "sentinel/sim/sim_update.hpp"
+
+#include "server_worker.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchConfig {
+    size_t   bots      = 64;
+    size_t   workers   = 1;
+    double   seconds   = 60.0;
+    int      tick_rate = 30;
+    float    fire      = 0.2f; // missiles per second per bot
+    float    area      = 300.0f;
+    uint64_t seed      = 1;
+
+    SimLinkConfig link;
+};
+
+struct BenchTally {
+    uint64_t joined        = 0;
+    uint64_t ticks_seen    = 0; // distinct world ticks, summed over bots
+    uint64_t ticks_elapsed = 0; // ticks since each bot's welcome, summed
+    uint64_t datagrams_in  = 0;
+    uint64_t bytes_in      = 0;
+    uint64_t events_in     = 0; // reliable messages from the server
+    uint64_t events_lost   = 0; // missile events refused, window full
+    double   world_delay_sum = 0.0; // tick scheduled -> bot read it
+    double   world_delay_max = 0.0;
+    uint64_t world_delays    = 0;
+};
+
+// ------------------------------------------------------------
+// Bot
+// ------------------------------------------------------------
+struct SimBot {
+    std::unique_ptr<UdpSocket> sock;
+    sockaddr_in server{};
+
+    uint32_t id = 0;
+
+    SimWorld  world;
+    SimPlayer player;
+    float     throttle = 0.0f, strafe = 0.0f, turn = 0.0f;
+    double    next_steer = 0.0;
+    uint32_t  seq = 0;
+
+    float    fire_credit = 0.0f;
+    uint32_t missile_id  = 0;
+
+    ReliableChannel   reliable;
+    ReliableStats     reliable_stats;
+    ReplicationClient replication;
+
+    uint32_t welcome_tick = 0;
+    double   welcome_time = 0.0;
+    uint32_t last_tick    = 0; // newest world tick seen
+};
+
+static void handle(SimBot& b, const uint8_t* packet, size_t n, double now,
+                   BenchTally& t) {
+    if (n < sizeof(PacketHeader))
+        return;
+
+    PacketHeader type{};
+    std::memcpy(&type, packet, sizeof(type));
+    if (type.version != PROTOCOL_VERSION)
+        return;
+
+    if (type.type == PacketType::RELIABLE) {
+        if (b.reliable.receive(packet, n, now)) {
+            const uint8_t* msg;
+            size_t         len;
+            while (b.reliable.pop(msg, len))
+                t.events_in++;
+        }
+        return;
+    }
+
+    if (n == sizeof(PlayerState) && type.type == PacketType::PLAYER_STATE) {
+        PlayerState st{};
+        std::memcpy(&st, packet, sizeof(st));
+        b.reliable.on_ack(st.acks, now);
+        return;
+    }
+
+    WorldSnapshotHeader hdr{};
+    if (read_world_snapshot_header(packet, n, hdr)) {
+        if (b.welcome_time > 0.0 && hdr.tick > b.last_tick) {
+            b.last_tick = hdr.tick;
+            t.ticks_seen++;
+
+            const double sched = b.welcome_time +
+                double(int64_t(hdr.tick) - int64_t(b.welcome_tick)) /
+                double(hdr.tick_rate);
+            const double delay = now - sched;
+            t.world_delay_sum += delay;
+            t.world_delays++;
+            if (delay > t.world_delay_max)
+                t.world_delay_max = delay;
+        }
+        b.replication.ingest(packet, n, now);
+        return;
+    }
+
+    if (n == sizeof(Snapshot) && type.type == PacketType::SNAPSHOT &&
+        b.id == 0) {
+        Snapshot welcome{};
+        std::memcpy(&welcome, packet, sizeof(welcome));
+
+        b.id = welcome.player_id;
+        b.player.x   = welcome.x;
+        b.player.y   = welcome.y;
+        b.player.z   = welcome.z;
+        b.player.yaw = welcome.yaw;
+        b.welcome_tick = welcome.tick;
+        b.welcome_time = welcome.sched_time;
+        b.last_tick    = welcome.tick;
+        t.joined++;
+    }
+}
+
+static void drain(SimBot& b, double now, BenchTally& t) {
+    uint8_t packet[BUNDLE_MTU];
+    sockaddr_in from{};
+    ssize_t n;
+
+    while ((n = b.sock->recv_from(packet, sizeof(packet), from)) > 0) {
+        t.datagrams_in++;
+        t.bytes_in += uint64_t(n);
+
+        PacketHeader head{};
+        std::memcpy(&head, packet, sizeof(head));
+
+        if (head.version == PROTOCOL_VERSION &&
+            head.type == PacketType::BUNDLE) {
+            read_bundle(packet, size_t(n),
+                        [&](const uint8_t* data, size_t size) {
+                            handle(b, data, size, now, t);
+                        });
+        } else {
+            handle(b, packet, size_t(n), now, t);
+        }
+    }
+}
+
+static void step(SimBot& b, const BenchConfig& config, float dt, double now,
+                 std::mt19937& rng, BenchTally& t) {
+    // HELLO is unreliable; repeat it every second until welcomed
+    if (b.id == 0) {
+        if (b.seq++ % uint32_t(config.tick_rate) == 0) {
+            Hello hello{};
+            b.sock->send_to(&hello, sizeof(hello), b.server);
+        }
+        return;
+    }
+
+    if (now >= b.next_steer) {
+        std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+        b.throttle = 0.5f + 0.5f * u(rng);
+        b.strafe   = 0.3f * u(rng);
+        b.turn     = 0.5f * u(rng);
+        b.next_steer = now + 2.0 + double(u(rng));
+    }
+
+    float turn = b.turn;
+    float r2 = b.player.x * b.player.x + b.player.z * b.player.z;
+    if (r2 > config.area * config.area) {
+        float home = std::atan2(-b.player.z, -b.player.x);
+        float off  = std::remainder(home - b.player.yaw, 6.28318531f);
+        turn = std::fmax(-1.0f, std::fmin(1.0f, 2.0f * off));
+    }
+
+    SimInput in;
+    in.throttle = b.throttle;
+    in.strafe   = b.strafe;
+    in.yaw      = turn;
+    sim_update(b.world, b.player, in, dt);
+
+    InputCmd cmd{};
+    cmd.player_id = b.id;
+    cmd.tick      = ++b.seq;
+    cmd.throttle  = in.throttle;
+    cmd.strafe    = in.strafe;
+    cmd.yaw       = in.yaw;
+    cmd.acks      = b.reliable.acks();
+
+    OutPacket out[3];
+    size_t    count = 0;
+    out[count++] = OutPacket{ &cmd, sizeof(cmd), b.server };
+
+    for (b.fire_credit += config.fire * dt; b.fire_credit >= 1.0f;
+         b.fire_credit -= 1.0f) {
+        const float fx = std::cos(b.player.yaw), fz = std::sin(b.player.yaw);
+
+        MissileFireEvent ev{};
+        ev.owner_id   = b.id;
+        ev.missile_id = ++b.missile_id;
+        ev.x  = b.player.x + fx * 1.4f;
+        ev.y  = b.player.y;
+        ev.z  = b.player.z + fz * 1.4f;
+        ev.vx = fx * MISSILE_SPEED;
+        ev.vz = fz * MISSILE_SPEED;
+        if (!b.reliable.send(&ev, sizeof(ev), b.reliable_stats))
+            t.events_lost++;
+    }
+
+    uint8_t rel[RELIABLE_MTU];
+    if (size_t n = b.reliable.write(rel, sizeof(rel), now, b.reliable_stats))
+        out[count++] = OutPacket{ rel, n, b.server };
+
+    uint32_t ack_tick = 0;
+    SnapshotAck ack{};
+    if (b.replication.take_ack(ack_tick)) {
+        ack.tick = ack_tick;
+        out[count++] = OutPacket{ &ack, sizeof(ack), b.server };
+    }
+
+    b.sock->send_batch(std::span<const OutPacket>(out, count));
+}
+
+static bool parse_shape(const char* name, SimJitter& out) {
+    if (strcmp(name, "uniform") == 0)     out = SimJitter::UNIFORM;
+    else if (strcmp(name, "normal") == 0) out = SimJitter::NORMAL;
+    else if (strcmp(name, "pareto") == 0) out = SimJitter::PARETO;
+    else return false;
+    return true;
+}
+
+// ------------------------------------------------------------
+// main
+// ------------------------------------------------------------
+int main(int argc, char** argv) {
+    BenchConfig config;
+    config.link.latency = 0.040;
+    config.link.jitter  = 0.010;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool more = i + 1 < argc;
+        if (strcmp(argv[i], "--bots") == 0 && more)
+            config.bots = size_t(atol(argv[++i]));
+        else if (strcmp(argv[i], "--workers") == 0 && more)
+            config.workers = size_t(atol(argv[++i]));
+        else if (strcmp(argv[i], "--seconds") == 0 && more)
+            config.seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--tick-rate") == 0 && more)
+            config.tick_rate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--fire") == 0 && more)
+            config.fire = float(atof(argv[++i]));
+        else if (strcmp(argv[i], "--latency") == 0 && more)
+            config.link.latency = atof(argv[++i]) * 1e-3;
+        else if (strcmp(argv[i], "--jitter") == 0 && more)
+            config.link.jitter = atof(argv[++i]) * 1e-3;
+        else if (strcmp(argv[i], "--shape") == 0 && more &&
+                 parse_shape(argv[i + 1], config.link.jitter_shape))
+            ++i;
+        else if (strcmp(argv[i], "--loss") == 0 && more)
+            config.link.loss = atof(argv[++i]);
+        else if (strcmp(argv[i], "--duplicate") == 0 && more)
+            config.link.duplicate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--reorder") == 0 && more)
+            config.link.reorder = atof(argv[++i]);
+        else if (strcmp(argv[i], "--bandwidth") == 0 && more)
+            config.link.bandwidth = atof(argv[++i]) * 1e3;
+        else if (strcmp(argv[i], "--seed") == 0 && more)
+            config.seed = strtoull(argv[++i], nullptr, 10);
+        else {
+            fprintf(stderr, "usage: %s [--bots N] [--workers W] [--seconds S] "
+                            "[--tick-rate 20|30|60] [--fire PER_S] "
+                            "[--latency MS] [--jitter MS] "
+                            "[--shape uniform|normal|pareto] [--loss P] "
+                            "[--duplicate P] [--reorder P] "
+                            "[--bandwidth KB/S] [--seed X]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (config.tick_rate != 20 && config.tick_rate != 30 &&
+        config.tick_rate != 60) {
+        fprintf(stderr, "[net_sim_bench] --tick-rate must be 20, 30 or 60\n");
+        return 1;
+    }
+
+    if (config.bots == 0 || config.workers < 1 || config.workers > 64 ||
+        config.seconds <= 0.0) {
+        fprintf(stderr, "[net_sim_bench] need 1+ bots, 1..64 workers "
+                        "and a positive duration\n");
+        return 1;
+    }
+
+    printf("[net_sim_bench] %zu bots, %zu worker(s), %.0f s at %d Hz; "
+           "latency %.1f ms + %.1f ms jitter, loss %.3f, dup %.3f, "
+           "reorder %.3f, bandwidth %.0f KB/s, seed %llu\n",
+        config.bots, config.workers, config.seconds, config.tick_rate,
+        config.link.latency * 1e3, config.link.jitter * 1e3,
+        config.link.loss, config.link.duplicate, config.link.reorder,
+        config.link.bandwidth * 1e-3, (unsigned long long)config.seed);
+
+    SimNetwork net(config.seed);
+    net.set_default_link(config.link);
+
+    // ---- server: one socket per worker, all on the virtual clock ----
+    ServerConfig server_config;
+    server_config.tick_rate = config.tick_rate;
+    server_config.workers   = config.workers;
+
+    ServerShared shared(server_config);
+    shared.epoch = timespec{};
+    shared.clock = [&net] { return net.now(); };
+
+    std::vector<std::unique_ptr<UdpSocket>>    server_socks;
+    std::vector<std::unique_ptr<ServerWorker>> workers;
+    for (size_t w = 0; w < config.workers; ++w) {
+        server_socks.emplace_back(net.create("10.0.0.1", uint16_t(7777 + w)));
+        workers.push_back(std::make_unique<ServerWorker>(shared, w));
+        workers.back()->attach(*server_socks.back());
+        shared.workers.push_back(workers.back().get());
+    }
+
+    // ---- bots, spread over the workers like SO_REUSEPORT would ----
+    std::vector<SimBot> bots(config.bots);
+    for (size_t i = 0; i < bots.size(); ++i) {
+        bots[i].sock.reset(net.create("10.0.1.1", 0));
+        bots[i].server = SimNetwork::address(
+            server_socks[i % config.workers].get());
+    }
+
+    std::mt19937 rng(uint32_t(config.seed));
+    BenchTally   tally;
+
+    const float  dt    = 1.0f / float(config.tick_rate);
+    const size_t steps = size_t(config.seconds * config.tick_rate);
+
+    const auto wall0 = Clock::now();
+
+    for (size_t s = 0; s < steps; ++s) {
+        const double now = net.now();
+
+        for (SimBot& b : bots) {
+            drain(b, now, tally);
+            step(b, config, dt, now, rng, tally);
+        }
+
+        net.advance(dt);
+
+        for (auto& w : workers)
+            w->poll();
+        for (auto& w : workers)
+            w->tick();
+    }
+
+    const double wall =
+        std::chrono::duration<double>(Clock::now() - wall0).count();
+
+    for (const SimBot& b : bots) {
+        if (b.welcome_time > 0.0)
+            tally.ticks_elapsed += steps - b.welcome_tick;
+    }
+
+    std::vector<const WorkerMetrics*> wm;
+    for (auto& w : workers)
+        wm.push_back(&w->metrics);
+
+    MetricsSnapshot m;
+    collect_metrics(wm, m);
+
+    printf("bots   %llu joined, world ticks %.1f%% seen, delay avg %.1f ms "
+           "max %.1f ms\n",
+        (unsigned long long)tally.joined,
+        tally.ticks_elapsed
+            ? 100.0 * double(tally.ticks_seen) / double(tally.ticks_elapsed)
+            : 0.0,
+        tally.world_delays
+            ? tally.world_delay_sum / double(tally.world_delays) * 1e3 : 0.0,
+        tally.world_delay_max * 1e3);
+
+    printf("bots   %llu datagrams / %llu bytes in, %llu server events, "
+           "%llu missile events refused\n",
+        (unsigned long long)tally.datagrams_in,
+        (unsigned long long)tally.bytes_in,
+        (unsigned long long)tally.events_in,
+        (unsigned long long)tally.events_lost);
+
+    printf("server %llu datagrams / %llu bytes out, %llu sessions, "
+           "%llu evicted, %llu reliable resent, tick p50 %.1f us "
+           "p99 %.1f us\n",
+        (unsigned long long)m.datagrams_out,
+        (unsigned long long)m.bytes_out,
+        (unsigned long long)m.sessions,
+        (unsigned long long)m.evictions,
+        (unsigned long long)m.reliable_resent,
+        double(m.tick_ns.percentile(0.5)) * 1e-3,
+        double(m.tick_ns.percentile(0.99)) * 1e-3);
+
+    const SimLinkStats ls = net.stats();
+    printf("links  sent %llu  delivered %llu  lost %llu  queue drop %llu  "
+           "dup %llu  reordered %llu\n",
+        (unsigned long long)ls.sent, (unsigned long long)ls.delivered,
+        (unsigned long long)ls.lost, (unsigned long long)ls.queue_drop,
+        (unsigned long long)ls.duplicated, (unsigned long long)ls.reordered);
+
+    printf("time   %.1f virtual s in %.3f wall s (%.0fx real time)\n",
+        net.now(), wall, wall > 0.0 ? net.now() / wall : 0.0);
+
+    // Workers first, then every socket before the network
+    workers.clear();
+    server_socks.clear();
+    bots.clear();
+    return 0;
+}
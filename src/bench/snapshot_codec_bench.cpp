@@ -0,0 +1,176 @@
+// Snapshot codec benchmark: bytes per entity, encode/decode cost, and a
+// round-trip check against the stated quantization error bounds.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "sentinel/net/protocol/world_snapshot.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr size_t ENTITY_COUNT = 1024;
+static constexpr int    ITERATIONS   = 2000;
+
+static std::vector<EntityState> make_world(std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(-2000.0f, 2000.0f);
+    std::uniform_real_distribution<float> alt(0.0f, 200.0f);
+    std::uniform_real_distribution<float> ang(-20.0f, 20.0f); // unwrapped
+    std::uniform_real_distribution<float> pit(-1.2f, 1.2f);
+    std::uniform_real_distribution<float> vel(-30.0f, 30.0f);
+
+    std::vector<EntityState> w(ENTITY_COUNT);
+    for (size_t i = 0; i < w.size(); ++i) {
+        EntityState& e = w[i];
+        e.player_id = uint32_t(i + 1);
+        e.x = pos(rng); e.y = alt(rng); e.z = pos(rng);
+        e.yaw = ang(rng);
+        e.pitch = pit(rng);
+        e.vx = vel(rng); e.vy = vel(rng); e.vz = vel(rng);
+    }
+
+    return w;
+}
+
+// Moves `fraction` of the entities; the rest stay idle
+static std::vector<EntityState> step_world(const std::vector<EntityState>& w,
+                                           float fraction, std::mt19937& rng) {
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+
+    std::vector<EntityState> next = w;
+    for (EntityState& e : next) {
+        if (u(rng) >= fraction)
+            continue;
+
+        e.x += e.vx / 30.0f;
+        e.z += e.vz / 30.0f;
+        e.yaw += 0.05f;
+    }
+
+    return next;
+}
+
+static float angle_diff(float a, float b) {
+    float d = std::fmod(a - b, 2.0f * QUANT_PI);
+    if (d >  QUANT_PI) d -= 2.0f * QUANT_PI;
+    if (d < -QUANT_PI) d += 2.0f * QUANT_PI;
+    return std::fabs(d);
+}
+
+static bool check_round_trip(const std::vector<EntityState>& src,
+                             const std::vector<EntityState>& dst) {
+    const SnapshotQuantization& q = DEFAULT_SNAPSHOT_QUANTIZATION;
+
+    float err[8] = {};
+    for (size_t i = 0; i < src.size(); ++i) {
+        const EntityState& a = src[i];
+        const EntityState& b = dst[i];
+
+        err[0] = std::fmax(err[0], std::fabs(a.x - b.x));
+        err[1] = std::fmax(err[1], std::fabs(a.y - b.y));
+        err[2] = std::fmax(err[2], std::fabs(a.z - b.z));
+        err[3] = std::fmax(err[3], angle_diff(a.yaw, b.yaw));
+        err[4] = std::fmax(err[4], std::fabs(a.pitch - b.pitch));
+        err[5] = std::fmax(err[5], std::fabs(a.vx - b.vx));
+        err[6] = std::fmax(err[6], std::fabs(a.vy - b.vy));
+        err[7] = std::fmax(err[7], std::fabs(a.vz - b.vz));
+    }
+
+    const char* names[8] = { "x", "y", "z", "yaw", "pitch", "vx", "vy", "vz" };
+    const float bound[8] = {
+        q.x.max_error(), q.y.max_error(), q.z.max_error(),
+        angle_max_error(q.yaw_bits), q.pitch.max_error(),
+        q.vel.max_error(), q.vel.max_error(), q.vel.max_error()
+    };
+
+    bool ok = true;
+    for (int f = 0; f < 8; ++f) {
+        // Allow for float rounding on top of the quantization step
+        bool pass = err[f] <= bound[f] * 1.001f + 1e-6f;
+        printf("  %-5s max error %.6f  bound %.6f  %s\n",
+            names[f], err[f], bound[f], pass ? "ok" : "FAIL");
+        ok = ok && pass;
+    }
+
+    return ok;
+}
+
+static void run_case(const char* name,
+                     const std::vector<EntityState>& cur,
+                     uint32_t baseline_tick,
+                     const std::vector<EntityState>& base) {
+    std::vector<WorldPacket> parts;
+    std::vector<EntityState> decoded;
+    decoded.reserve(cur.size());
+
+    size_t part_count = 0;
+
+    auto t0 = Clock::now();
+    for (int it = 0; it < ITERATIONS; ++it) {
+        part_count = encode_world_snapshot(
+            2, 30, cur.data(), cur.size(),
+            baseline_tick, base.data(), base.size(), parts);
+    }
+    auto t1 = Clock::now();
+
+    size_t entities = 0;
+    size_t bytes = 0;
+
+    for (int it = 0; it < ITERATIONS; ++it) {
+        decoded.clear();
+        for (size_t p = 0; p < part_count; ++p) {
+            WorldSnapshotHeader hdr{};
+            read_world_snapshot_header(parts[p].bytes, parts[p].size, hdr);
+            decode_world_snapshot(parts[p].bytes, parts[p].size, hdr,
+                base.data(), base.size(), decoded);
+        }
+    }
+    auto t2 = Clock::now();
+
+    for (size_t p = 0; p < part_count; ++p)
+        bytes += parts[p].size;
+    entities = decoded.size();
+
+    double enc_ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    double dec_ns = std::chrono::duration<double, std::nano>(t2 - t1).count();
+    double per = double(ITERATIONS) * double(cur.size());
+
+    printf("%-14s %4zu parts  %6.2f bytes/entity  "
+           "encode %6.1f ns/entity  decode %6.1f ns/entity\n",
+        name, part_count,
+        entities ? double(bytes) / double(entities) : 0.0,
+        enc_ns / per, dec_ns / per);
+}
+
+int main() {
+    std::mt19937 rng(1234);
+
+    std::vector<EntityState> base = make_world(rng);
+    std::vector<EntityState> idle = step_world(base, 0.05f, rng);
+    std::vector<EntityState> busy = step_world(base, 1.0f, rng);
+
+    // Baselines are what the client decoded, not the raw server values
+    std::vector<WorldPacket> parts;
+    std::vector<EntityState> decoded_base;
+    size_t n = encode_world_snapshot(1, 30, base.data(), base.size(),
+                                     0, nullptr, 0, parts);
+    for (size_t p = 0; p < n; ++p) {
+        WorldSnapshotHeader hdr{};
+        read_world_snapshot_header(parts[p].bytes, parts[p].size, hdr);
+        decode_world_snapshot(parts[p].bytes, parts[p].size, hdr,
+            nullptr, 0, decoded_base);
+    }
+
+    printf("raw EntityState: %zu bytes/entity, %zu entities\n",
+        sizeof(EntityState), ENTITY_COUNT);
+
+    run_case("keyframe", busy, 0, {});
+    run_case("delta 5% move", idle, 1, base);
+    run_case("delta all move", busy, 1, base);
+
+    printf("round trip (keyframe):\n");
+    bool ok = check_round_trip(base, decoded_base);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+// UdpSocket backend benchmark: packets per second and CPU per packet of
+// the recvfrom and io_uring backends, over loopback.
+//
+//   udp_backend_bench [--packets N] [--size BYTES] [--senders T]
+//                     [--port P]
+//
+// recv: T plain sockets flood a backend socket until it has taken N
+// datagrams. CPU is the receiving thread's own time, so what the
+// senders cost is left out; loss shows as datagrams sent but not read.
+//
+// send: a backend socket sends N datagrams to a socket nobody reads.
+// The kernel's loopback delivery runs on the sending thread and is
+// counted for both backends alike.
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sentinel/net/transport/udp_socket.hpp"
+
+struct BenchConfig {
+    size_t   packets = 1000000;
+    size_t   size    = 64;
+    size_t   senders = 1;
+    uint16_t port    = 47100; // uses port .. port + 2
+};
+
+struct BenchResult {
+    double   seconds = 0.0; // wall
+    double   cpu     = 0.0; // measured thread
+    uint64_t packets = 0;
+    uint64_t offered = 0;   // recv: datagrams the senders got out
+};
+
+static double clock_seconds(clockid_t id) {
+    timespec ts{};
+    clock_gettime(id, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static sockaddr_in loopback(uint16_t port) {
+    sockaddr_in a{};
+    a.sin_family      = AF_INET;
+    a.sin_port        = htons(port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return a;
+}
+
+static const char* backend_name(UdpBackend b) {
+    return b == UdpBackend::IO_URING ? "io_uring" : "syscall";
+}
+
+// ------------------------------------------------------------
+// recv
+// ------------------------------------------------------------
+static BenchResult bench_recv(const BenchConfig& config, UdpBackend backend) {
+    BenchResult r;
+
+    std::atomic<bool>     ready{ false };
+    std::atomic<bool>     done{ false };
+    std::atomic<uint64_t> offered{ 0 };
+
+    // The socket lives on the thread that uses it; io_uring's ring
+    // accepts a single issuer
+    std::thread receiver([&] {
+        std::unique_ptr<UdpSocket> sock(
+            UdpSocket::create("0.0.0.0", config.port, backend));
+        ready = true;
+
+        std::vector<uint8_t> buf(2048);
+        sockaddr_in from{};
+
+        // The clock starts at the first datagram
+        if (sock->recv_from(buf.data(), buf.size(), from) <= 0) {
+            done = true;
+            return;
+        }
+
+        const double wall0 = clock_seconds(CLOCK_MONOTONIC);
+        const double cpu0  = clock_seconds(CLOCK_THREAD_CPUTIME_ID);
+
+        uint64_t got = 1;
+        while (got < config.packets) {
+            if (sock->recv_from(buf.data(), buf.size(), from) <= 0)
+                break;
+            ++got;
+        }
+
+        r.cpu     = clock_seconds(CLOCK_THREAD_CPUTIME_ID) - cpu0;
+        r.seconds = clock_seconds(CLOCK_MONOTONIC) - wall0;
+        r.packets = got - 1;
+        done = true;
+    });
+
+    while (!ready)
+        std::this_thread::yield();
+
+    std::vector<std::thread> senders;
+    for (size_t t = 0; t < config.senders; ++t) {
+        senders.emplace_back([&] {
+            int fd = socket(AF_INET, SOCK_DGRAM, 0);
+            const sockaddr_in to = loopback(config.port);
+            std::vector<uint8_t> payload(config.size, 0x5a);
+
+            uint64_t sent = 0;
+            while (!done) {
+                if (sendto(fd, payload.data(), payload.size(), 0,
+                           (const sockaddr*)&to, sizeof(to)) > 0)
+                    ++sent;
+            }
+
+            offered += sent;
+            close(fd);
+        });
+    }
+
+    receiver.join();
+    for (std::thread& t : senders)
+        t.join();
+
+    r.offered = offered;
+    return r;
+}
+
+// ------------------------------------------------------------
+// send
+// ------------------------------------------------------------
+static BenchResult bench_send(const BenchConfig& config, UdpBackend backend) {
+    BenchResult r;
+
+    // Bound so the datagrams have somewhere to go; never read
+    int sink = socket(AF_INET, SOCK_DGRAM, 0);
+    const sockaddr_in to = loopback(uint16_t(config.port + 2));
+    if (bind(sink, (const sockaddr*)&to, sizeof(to)) < 0) {
+        perror("bind sink");
+        close(sink);
+        return r;
+    }
+
+    std::vector<uint8_t> payload(config.size, 0xa5);
+
+    const double wall0 = clock_seconds(CLOCK_MONOTONIC);
+    const double cpu0  = clock_seconds(CLOCK_THREAD_CPUTIME_ID);
+
+    {
+        std::unique_ptr<UdpSocket> sock(UdpSocket::create(
+            "0.0.0.0", uint16_t(config.port + 1), backend));
+
+        for (size_t i = 0; i < config.packets; ++i) {
+            if (sock->send_to(payload.data(), payload.size(), to) > 0)
+                ++r.packets;
+        }
+    } // closing waits for io_uring's queued sends
+
+    r.cpu     = clock_seconds(CLOCK_THREAD_CPUTIME_ID) - cpu0;
+    r.seconds = clock_seconds(CLOCK_MONOTONIC) - wall0;
+
+    close(sink);
+    return r;
+}
+
+static void report(const char* what, UdpBackend backend,
+                   const BenchResult& r) {
+    if (r.packets == 0 || r.seconds <= 0.0) {
+        printf("%-4s %-8s  no packets\n", what, backend_name(backend));
+        return;
+    }
+
+    printf("%-4s %-8s  %10.0f pkt/s  %7.3f us cpu/pkt",
+        what, backend_name(backend),
+        double(r.packets) / r.seconds,
+        r.cpu * 1e6 / double(r.packets));
+
+    if (r.offered > 0) {
+        printf("  %5.1f%% of offered read",
+            100.0 * double(r.packets) / double(r.offered));
+    }
+
+    printf("\n");
+}
+
+// ------------------------------------------------------------
+// main
+// ------------------------------------------------------------
+int main(int argc, char** argv) {
+    BenchConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--packets") == 0 && i + 1 < argc)
+            config.packets = size_t(atol(argv[++i]));
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            config.size = size_t(atol(argv[++i]));
+        else if (strcmp(argv[i], "--senders") == 0 && i + 1 < argc)
+            config.senders = size_t(atol(argv[++i]));
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            config.port = uint16_t(atoi(argv[++i]));
+        else {
+            fprintf(stderr, "usage: %s [--packets N] [--size BYTES] "
+                            "[--senders T] [--port P]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (config.size == 0 || config.size > 1400 || config.packets < 2) {
+        fprintf(stderr, "need 1..1400 byte datagrams and 2+ packets\n");
+        return 1;
+    }
+
+    printf("[udp_backend_bench] %zu datagrams of %zu bytes, %zu sender(s)\n",
+        config.packets, config.size, config.senders);
+
+    const UdpBackend backends[] = { UdpBackend::SYSCALL, UdpBackend::IO_URING };
+
+    for (UdpBackend b : backends)
+        report("recv", b, bench_recv(config, b));
+
+    for (UdpBackend b : backends)
+        report("send", b, bench_send(config, b));
+
+    return 0;
+}
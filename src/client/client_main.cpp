@@ -30,11 +30,17 @@
 #include "client/camera.hpp"
 #include "client/render_sky.hpp"
 #include "client/render_drone_mesh.hpp"
+#include "client/prediction.hpp"
 
 #include "sentinel/net/net_api.hpp"
 #include "sentinel/net/replication/replication_client.hpp"
+#include "sentinel/net/reliable/reliable_channel.hpp"
 #include "sentinel/net/protocol/snapshot.hpp"
+#include "sentinel/net/protocol/world_snapshot.hpp"
 #include "sentinel/net/protocol/chat.hpp"
+#include "sentinel/net/protocol/dispatch.hpp"
+#include "sentinel/net/protocol/bundle.hpp"
+#include "sentinel/sim/missile.hpp"
 
 // ------------------------------------------------------------
 // Forward declarations (required by C++)
@@ -103,17 +109,11 @@ constexpr float UFO_DRIFT_DAMPING = 0.96f;  // floatiness
 // ------------------------------------------------------------
 // Tuning (VISUAL FIDELITY MODE)
 // ------------------------------------------------------------
-constexpr float MOVE_SPEED     = 9.0f;
-constexpr float STRAFE_SPEED   = 8.0f;
-constexpr float VERTICAL_SPEED = 6.0f;
-constexpr float YAW_SPEED      = 1.8f;
-
+// Flight speeds live in sim_update.cpp and missile tuning in
+// sentinel/sim/missile.hpp, shared with the server
 constexpr float CAM_BACK = 8.0f;
 constexpr float CAM_UP   = 4.5f;
 
-constexpr float MISSILE_SPEED = 28.0f;
-constexpr float MISSILE_LIFE = 4.0f;   // seconds
-constexpr float EXPLOSION_MAX_RADIUS = 6.0f;
 constexpr float EXPLOSION_DURATION = 0.6f;
 
 // ---- Camera zoom (mouse wheel) ----
@@ -123,9 +123,6 @@ constexpr float CAM_MIN = 3.0f;
 constexpr float CAM_MAX = 25.0f;
 constexpr float CAM_ZOOM_SPEED = 1.2f;
 
-// Larger delay = smoother remote motion
-constexpr double INTERP_DELAY = 0.45; // seconds
-
 
 
 static TTF_Font* g_chat_font = nullptr;
@@ -231,12 +228,27 @@ static IdlePose compute_idle_pose(uint32_t player_id, double t) {
 
 struct Missile {
     bool active = false;
+    uint32_t id = 0;
     float x, y, z;
     float vx, vy, vz;
 };
 
 static Missile missile;
 
+// Other players' shots, flown from the server's relayed MissileFireEvent
+// until their MissileExplodeEvent arrives or MISSILE_LIFE runs out
+struct RemoteMissile {
+    bool active = false;
+    uint32_t owner_id = 0;
+    uint32_t id = 0;
+    float x, y, z;
+    float vx, vy, vz;
+    float age;
+};
+
+static constexpr int MAX_REMOTE_MISSILES = 32;
+static RemoteMissile remote_missiles[MAX_REMOTE_MISSILES];
+
 struct Explosion {
     bool active = false;
     float x, y, z;
@@ -246,6 +258,141 @@ struct Explosion {
 
 static Explosion explosion;
 
+// ------------------------------------------------------------
+// Incoming packets
+// ------------------------------------------------------------
+// Datagrams taken per net_recv_raw_batch(); a frame's worth of world
+// bundles and reliable traffic usually fits in one call
+static constexpr int CLIENT_RECV_BATCH = 16;
+
+struct ClientPackets {
+    ReplicationClient& replication;
+    LocalPrediction&   prediction;
+    ReliableChannel&   reliable;
+    uint32_t&          local_player_id;
+    double             now = 0.0; // seconds, set before each receive
+
+    // WORLD_SNAPSHOT: every entity for one server tick
+    void on_packet(const WorldSnapshotHeader&, const uint8_t* data,
+                   size_t size, const sockaddr_in&) {
+        replication.ingest(data, size, now);
+    }
+
+    void on_packet(const Snapshot& s, const sockaddr_in&) {
+        replication.ingest(s);
+
+        if (local_player_id == 0) {
+            local_player_id = s.player_id;
+
+            // The welcome carries the server's spawn
+            SimPlayer spawn;
+            spawn.x = s.x; spawn.y = s.y; spawn.z = s.z;
+            spawn.yaw   = s.yaw;
+            spawn.pitch = s.pitch;
+            prediction.reset(spawn);
+
+            printf("[client] assigned id=%u\n", local_player_id);
+        }
+    }
+
+    void on_packet(const PlayerState& s, const sockaddr_in&) {
+        if (local_player_id != 0)
+            prediction.reconcile(s);
+
+        reliable.on_ack(s.acks, now);
+    }
+
+    // Chat and missile events, in order, each dispatched as a packet
+    void on_packet(const ReliablePacket&, const uint8_t* data, size_t size,
+                   const sockaddr_in& from);
+
+    // The server's whole tick for us, several packets per datagram
+    void on_packet(const BundleHeader&, const uint8_t* data, size_t size,
+                   const sockaddr_in& from);
+
+    // Another player fired near us; our own shots are already flying
+    void on_packet(const MissileFireEvent& ev, const sockaddr_in&) {
+        if (ev.owner_id == local_player_id)
+            return;
+
+        // Reuse a free slot, else the oldest shot
+        RemoteMissile* slot = &remote_missiles[0];
+        for (RemoteMissile& m : remote_missiles) {
+            if (!m.active) {
+                slot = &m;
+                break;
+            }
+            if (m.age > slot->age)
+                slot = &m;
+        }
+
+        slot->active = true;
+        slot->owner_id = ev.owner_id;
+        slot->id = ev.missile_id;
+        slot->x = ev.x;   slot->y = ev.y;   slot->z = ev.z;
+        slot->vx = ev.vx; slot->vy = ev.vy; slot->vz = ev.vz;
+        slot->age = 0.0f;
+    }
+
+    // The server ends missiles: hits, expiries and other players' shots
+    void on_packet(const MissileExplodeEvent& ev, const sockaddr_in&) {
+        if (ev.owner_id == local_player_id) {
+            // Our own detonation already played when we sent it
+            if (!missile.active || ev.missile_id != missile.id)
+                return;
+            missile.active = false;
+        } else {
+            for (RemoteMissile& m : remote_missiles) {
+                if (m.active && m.owner_id == ev.owner_id &&
+                    m.id == ev.missile_id)
+                    m.active = false;
+            }
+        }
+
+        explosion.active = true;
+        explosion.x = ev.x;
+        explosion.y = ev.y;
+        explosion.z = ev.z;
+        explosion.radius = 0.2f;
+        explosion.time = 0.0f;
+    }
+
+    void on_packet(const ChatMessage& msg, const sockaddr_in&) {
+        std::string line =
+            std::string(msg.name) + ": " + std::string(msg.text);
+        push_chat_line(line);
+    }
+};
+
+// Anything the server sends alone or inside a bundle
+using ClientMessageDispatch = PacketDispatcher<ClientPackets, sockaddr_in,
+    WorldSnapshotHeader, Snapshot, PlayerState, ReliablePacket>;
+
+using ClientDispatch = PacketDispatcher<ClientPackets, sockaddr_in,
+    WorldSnapshotHeader, Snapshot, PlayerState, ReliablePacket,
+    BundleHeader>;
+
+using ClientReliableDispatch = PacketDispatcher<ClientPackets, sockaddr_in,
+    MissileFireEvent, MissileExplodeEvent, ChatMessage>;
+
+void ClientPackets::on_packet(const ReliablePacket&, const uint8_t* data,
+                              size_t size, const sockaddr_in& from) {
+    if (!reliable.receive(data, size, now))
+        return;
+
+    const uint8_t* msg;
+    size_t         len;
+    while (reliable.pop(msg, len))
+        ClientReliableDispatch::dispatch(*this, msg, len, from);
+}
+
+void ClientPackets::on_packet(const BundleHeader&, const uint8_t* data,
+                              size_t size, const sockaddr_in& from) {
+    read_bundle(data, size, [&](const uint8_t* packet, size_t len) {
+        ClientMessageDispatch::dispatch(*this, packet, len, from);
+    });
+}
+
 
 struct UfoNPC {
     float x;
@@ -309,6 +456,17 @@ static float lerp(float a, float b, float t) {
     return a + (b - a) * t;
 }
 
+// Shortest-arc blend; world snapshots wrap yaw into [-pi, pi)
+static float lerp_angle(float a, float b, float t) {
+    constexpr float TWO_PI = 6.28318530718f;
+
+    float d = std::fmod(b - a, TWO_PI);
+    if (d >  TWO_PI * 0.5f) d -= TWO_PI;
+    if (d < -TWO_PI * 0.5f) d += TWO_PI;
+
+    return a + d * t;
+}
+
 static float clamp01(float v) {
     if (v < 0.0f) return 0.0f;
     if (v > 1.0f) return 1.0f;
@@ -1036,8 +1194,7 @@ SDL_StartTextInput();
     server.sin_port   = htons(7777);
     inet_pton(AF_INET, "146.71.76.134", &server.sin_addr);
 
-    PacketHeader hello{};
-    hello.type = PacketType::HELLO;
+    Hello hello{};
     net_send_raw_to(&hello, sizeof(hello), server);
 
     ReplicationClient replication;
@@ -1047,11 +1204,32 @@ SDL_StartTextInput();
     float drone_yaw = 0.0f;
     float camera_yaw = 0.0f;
 
+    // Own drone: predicted from local input, corrected by the server
+    LocalPrediction prediction;
+    float           input_accum = 0.0f; // seconds toward the next tick
+
+    // Chat and missile events both ways
+    ReliableChannel reliable;
+    ReliableStats   reliable_stats;
+
+    ClientPackets packets{ replication, prediction, reliable,
+                           local_player_id };
+
+    static uint8_t rx_bytes[CLIENT_RECV_BATCH][WORLD_SNAPSHOT_MTU];
+    InPacket rx[CLIENT_RECV_BATCH];
+    for (int i = 0; i < CLIENT_RECV_BATCH; ++i) {
+        rx[i].data     = rx_bytes[i];
+        rx[i].capacity = sizeof(rx_bytes[i]);
+    }
+
 
     Camera cam{};
 
     // Track which players are "ready to render"
     std::unordered_map<uint32_t, bool> has_remote;
+    std::vector<uint32_t> remote_ids;
+
+    Uint32 last_hello = SDL_GetTicks();
 
     Uint32 last_ticks = SDL_GetTicks();
     bool running = true;
@@ -1075,6 +1253,20 @@ SDL_StartTextInput();
             missile.z += missile.vz * dt;
         }
 
+        for (RemoteMissile& m : remote_missiles) {
+            if (!m.active)
+                continue;
+
+            m.x += m.vx * dt;
+            m.y += m.vy * dt;
+            m.z += m.vz * dt;
+
+            // The explode event normally ends it first
+            m.age += dt;
+            if (m.age >= MISSILE_LIFE)
+                m.active = false;
+        }
+
         if (explosion.active) {
             explosion.time += dt;
 
@@ -1151,7 +1343,7 @@ SDL_StartTextInput();
                         msg.name[MAX_NAME_LEN - 1] = '\0';
 
                         strncpy(msg.text, chat_buffer.c_str(), MAX_CHAT_TEXT - 1);
-                        net_send_raw_to(&msg, sizeof(msg), server);
+                        reliable.send(&msg, sizeof(msg), reliable_stats);
                     }
 
                     chat_active = !chat_active;
@@ -1224,6 +1416,16 @@ SDL_StartTextInput();
                 missile.vx = std::cos(drone_yaw) * MISSILE_SPEED;
                 missile.vy = 0.0f;
                 missile.vz = std::sin(drone_yaw) * MISSILE_SPEED;
+                ++missile.id;
+
+                if (local_player_id != 0) {
+                    MissileFireEvent ev{};
+                    ev.owner_id = local_player_id;
+                    ev.missile_id = missile.id;
+                    ev.x = missile.x; ev.y = missile.y; ev.z = missile.z;
+                    ev.vx = missile.vx; ev.vy = missile.vy; ev.vz = missile.vz;
+                    reliable.send(&ev, sizeof(ev), reliable_stats);
+                }
             }
             else {
                 // DETONATE missile
@@ -1235,6 +1437,15 @@ SDL_StartTextInput();
                 explosion.z = missile.z;
                 explosion.radius = 0.2f;
                 explosion.time = 0.0f;
+
+                // The server rewinds to what we saw and names the target
+                if (local_player_id != 0) {
+                    MissileExplodeEvent ev{};
+                    ev.owner_id = local_player_id;
+                    ev.missile_id = missile.id;
+                    ev.x = missile.x; ev.y = missile.y; ev.z = missile.z;
+                    reliable.send(&ev, sizeof(ev), reliable_stats);
+                }
             }
 
         }
@@ -1313,22 +1524,47 @@ SDL_StartTextInput();
         }
 
 
-        drone_yaw += turn * YAW_SPEED * dt;
-        camera_yaw = drone_yaw;
-
-        float cy = std::cos(drone_yaw);
-        float sy = std::sin(drone_yaw);
-
+        // Fixed server ticks: predict each at once and send it as an
+        // InputCmd; the server runs the same step a little later
+        if (local_player_id != 0 && prediction.ready()) {
+            const float tick_dt = prediction.tick_dt();
+
+            // After a hitch, catch up a few ticks rather than flood
+            input_accum = std::fmin(input_accum + dt, 4.0f * tick_dt);
+
+            while (input_accum >= tick_dt) {
+                SimInput in;
+                in.throttle = forward;
+                in.strafe   = strafe;
+                in.vertical = vertical;
+                in.yaw      = turn;
+                in.boost    = boost_active;
+
+                InputCmd cmd{};
+                cmd.player_id = local_player_id;
+                cmd.tick      = prediction.step(in);
+                cmd.throttle  = in.throttle;
+                cmd.strafe    = in.strafe;
+                cmd.vertical  = in.vertical;
+                cmd.yaw       = in.yaw;
+                cmd.buttons   = in.boost ? INPUT_BUTTON_BOOST : 0;
+                cmd.acks      = reliable.acks();
+
+                net_send_raw_to(&cmd, sizeof(cmd), server);
+                input_accum -= tick_dt;
+            }
 
-        float speed_mul = boost_active ? 2.0f : 1.0f;
+            prediction.decay(dt);
 
-        px += (cy * forward * MOVE_SPEED * speed_mul +
-            -sy * strafe * STRAFE_SPEED * speed_mul) * dt;
+            SimPlayer view = prediction.render(input_accum / tick_dt);
+            px = view.x; py = view.y; pz = view.z;
+            drone_yaw = view.yaw;
+        }
 
-        pz += (sy * forward * MOVE_SPEED * speed_mul +
-            cy * strafe * STRAFE_SPEED * speed_mul) * dt;
+        camera_yaw = drone_yaw;
 
-        py += vertical * VERTICAL_SPEED * speed_mul * dt;
+        float cy = std::cos(drone_yaw);
+        float sy = std::sin(drone_yaw);
 
 
         // ---- Rotor trails (4x) ----
@@ -1371,47 +1607,45 @@ SDL_StartTextInput();
         );
 
 
-        uint8_t packet[512];
-        sockaddr_in from{};
-        ssize_t n;
-
-        while ((n = net_recv_raw_from(packet, sizeof(packet), from)) > 0) {
-
-            if (n == sizeof(Snapshot)) {
-                Snapshot s{};
-                memcpy(&s, packet, sizeof(s));
-                replication.ingest(s);
-
-                if (local_player_id == 0) {
-                    local_player_id = s.player_id;
-                    printf("[client] assigned id=%u\n", local_player_id);
-                }
-            }
-            else if (n == sizeof(ChatMessage)) {
-                ChatMessage msg{};
-                memcpy(&msg, packet, sizeof(msg));
-
-                std::string line =
-                    std::string(msg.name) + ": " + std::string(msg.text);
-                push_chat_line(line);
+        // Everything queued since last frame, a batch per syscall; a
+        // short batch means the socket is drained
+        packets.now = now * 0.001;
+        int n;
+        while ((n = net_recv_raw_batch(rx)) > 0) {
+            for (int i = 0; i < n; ++i) {
+                ClientDispatch::dispatch(packets, (const uint8_t*)rx[i].data,
+                                         rx[i].size, rx[i].from);
             }
+            if (n < CLIENT_RECV_BATCH)
+                break;
         }
 
+        // This frame's outgoing datagrams, sent together below
+        OutPacket tx[3];
+        size_t    tx_count = 0;
 
+        // HELLO is unreliable; repeat it until the server assigns an id
+        if (local_player_id == 0 && now - last_hello >= 1000) {
+            tx[tx_count++] = OutPacket{ &hello, sizeof(hello), server };
+            last_hello = now;
+        }
 
+        // Ack the newest complete world so the server can delta against it
+        uint32_t ack_tick = 0;
+        SnapshotAck ack{};
+        if (replication.take_ack(ack_tick)) {
+            ack.tick = ack_tick;
+            tx[tx_count++] = OutPacket{ &ack, sizeof(ack), server };
+        }
 
-        // Send local snapshot
-        if (local_player_id != 0) {
-            Snapshot out{};
-            out.player_id   = local_player_id;
-            out.x           = px;
-            out.y           = py;
-            out.z           = pz;
-            out.yaw         = drone_yaw;
-            out.server_time = now * 0.001;
+        // New reliable messages, and old ones past their resend time
+        uint8_t out[RELIABLE_MTU];
+        if (size_t len = reliable.write(out, sizeof(out), now * 0.001,
+                                        reliable_stats))
+            tx[tx_count++] = OutPacket{ out, len, server };
 
-            net_send_raw_to(&out, sizeof(out), server);
-        }
+        if (tx_count > 0)
+            net_send_raw_batch(std::span<const OutPacket>(tx, tx_count));
 
         cam.target = { px, py, pz };
 
@@ -1657,6 +1891,17 @@ draw_terrain(cam.pos.x, cam.pos.z);
             glPopMatrix();
         }
 
+        for (const RemoteMissile& m : remote_missiles) {
+            if (!m.active)
+                continue;
+
+            glPushMatrix();
+            glTranslatef(m.x, m.y, m.z);
+            glRotatef(std::atan2(m.vz, m.vx) * 57.2958f, 0, 1, 0);
+            draw_missile();
+            glPopMatrix();
+        }
+
         if (explosion.active) {
             float t = explosion.time / EXPLOSION_DURATION;
             float alpha = 1.0f - t;
@@ -1720,9 +1965,13 @@ draw_terrain(cam.pos.x, cam.pos.z);
 
 
         // Remote drones (SMOOTH MODE)
-        double render_time = now * 0.001 - INTERP_DELAY;
+        // On the server's tick timeline, not the client's own clock
+        double render_time =
+            replication.render_time(now * 0.001, INTERP_DELAY);
+
+        replication.player_ids(remote_ids);
 
-        for (uint32_t pid = 1; pid < 64; ++pid) {
+        for (uint32_t pid : remote_ids) {
             if (pid == local_player_id)
                 continue;
 
@@ -1742,7 +1991,7 @@ draw_terrain(cam.pos.x, cam.pos.z);
             float ry = lerp(a.y, b.y, alpha);
             float rz = lerp(a.z, b.z, alpha);
 
-            float ryaw = lerp(a.yaw, b.yaw, alpha);
+            float ryaw = lerp_angle(a.yaw, b.yaw, alpha);
             bool idle = is_idle(a, b);
 
             IdlePose idle_pose{};
@@ -0,0 +1,103 @@
+#include "client/prediction.hpp"
+
+#include <cmath>
+
+// Correction blending
+static constexpr float SMOOTH_RATE   = 10.0f; // offset decay, 1/s
+static constexpr float SNAP_DISTANCE = 8.0f;  // larger errors just jump
+
+static float wrap_angle(float a) {
+    return std::remainder(a, 6.28318531f);
+}
+
+void LocalPrediction::reset(const SimPlayer& spawn) {
+    current  = spawn;
+    previous = spawn;
+
+    for (Pending& p : pending)
+        p = Pending{};
+
+    next_tick  = 1;
+    state_tick = 0;
+    ox = oy = oz = oyaw = 0.0f;
+    error = 0.0f;
+}
+
+uint32_t LocalPrediction::step(const SimInput& input) {
+    const uint32_t tick = next_tick++;
+
+    Pending& p = pending[tick & (HISTORY - 1)];
+    p.tick  = tick;
+    p.input = input;
+
+    previous = current;
+    sim_update(world, current, input, dt);
+    return tick;
+}
+
+void LocalPrediction::reconcile(const PlayerState& s) {
+    if (s.tick_rate == 0)
+        return;
+
+    // Out of order; a newer state already covered it
+    if (state_tick != 0 && int32_t(s.tick - state_tick) <= 0)
+        return;
+    state_tick = s.tick;
+
+    dt = 1.0f / float(s.tick_rate);
+
+    const SimPlayer before = current;
+
+    current.x = s.x; current.y = s.y; current.z = s.z;
+    current.yaw   = s.yaw;
+    current.pitch = s.pitch;
+    previous = current;
+
+    // Replay what the server has not applied yet. Anything older than
+    // the ring is gone; the correction absorbs it.
+    uint32_t first = s.input_tick + 1;
+    if (next_tick - first > HISTORY)
+        first = next_tick - HISTORY;
+
+    for (uint32_t t = first; t != next_tick; ++t) {
+        const Pending& p = pending[t & (HISTORY - 1)];
+        if (p.tick != t)
+            continue;
+
+        previous = current;
+        sim_update(world, current, p.input, dt);
+    }
+
+    // Keep the drawn drone where it was and blend toward the new path
+    float dx = before.x - current.x;
+    float dy = before.y - current.y;
+    float dz = before.z - current.z;
+
+    error = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+    ox += dx; oy += dy; oz += dz;
+    oyaw = wrap_angle(oyaw + before.yaw - current.yaw);
+
+    if (ox * ox + oy * oy + oz * oz > SNAP_DISTANCE * SNAP_DISTANCE)
+        ox = oy = oz = oyaw = 0.0f;
+}
+
+SimPlayer LocalPrediction::render(float alpha) const {
+    SimPlayer r = current;
+
+    r.x = previous.x + (current.x - previous.x) * alpha + ox;
+    r.y = previous.y + (current.y - previous.y) * alpha + oy;
+    r.z = previous.z + (current.z - previous.z) * alpha + oz;
+
+    r.yaw = previous.yaw + wrap_angle(current.yaw - previous.yaw) * alpha +
+            oyaw;
+    r.pitch = previous.pitch + (current.pitch - previous.pitch) * alpha;
+    return r;
+}
+
+void LocalPrediction::decay(float frame_dt) {
+    const float k = std::exp(-SMOOTH_RATE * frame_dt);
+
+    ox *= k; oy *= k; oz *= k;
+    oyaw *= k;
+}
@@ -0,0 +1,117 @@
+#include "sentinel/net/buffer/packet_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+// Buffers start on cache lines, so a packet struct at offset 0 of a
+// fresh buffer is aligned for anything it holds
+static constexpr size_t BUFFER_ALIGN = 64;
+
+// ------------------------------------------------------------
+// PacketRef
+// ------------------------------------------------------------
+void PacketRef::reset() {
+    if (buf && --buf->refs == 0)
+        buf->pool->release(buf);
+
+    buf    = nullptr;
+    offset = 0;
+    length = 0;
+}
+
+size_t PacketRef::capacity() const {
+    return buf ? buf->pool->buffer_bytes() - offset : 0;
+}
+
+PacketRef PacketRef::slice(size_t at, size_t size) const {
+    assert(buf && at + size <= length);
+
+    ++buf->refs;
+    return PacketRef(buf, offset + uint32_t(at), uint32_t(size));
+}
+
+// ------------------------------------------------------------
+// PacketPool
+// ------------------------------------------------------------
+PacketPool::PacketPool(size_t buffer_bytes, size_t slab_buffers,
+                       size_t max_buffers_)
+    : bytes_per_buffer((buffer_bytes + BUFFER_ALIGN - 1) &
+                       ~(BUFFER_ALIGN - 1)),
+      slab_size(slab_buffers ? slab_buffers : 1),
+      max_buffers(max_buffers_) {}
+
+PacketPool::~PacketPool() {
+    // A ref outliving its pool would write into freed slabs
+    assert(in_use == 0);
+}
+
+bool PacketPool::grow() {
+    const size_t have = slabs.size() * slab_size;
+    if (have >= max_buffers)
+        return false;
+
+    const size_t n = std::min(slab_size, max_buffers - have);
+
+    Slab s;
+    s.bytes.reset(new uint8_t[n * bytes_per_buffer + BUFFER_ALIGN]);
+    s.buffers.reset(new Buffer[n]);
+
+    uint8_t* base = s.bytes.get();
+    base += (BUFFER_ALIGN - uintptr_t(base) % BUFFER_ALIGN) % BUFFER_ALIGN;
+
+    // Thread onto the free list in address order
+    for (size_t i = n; i-- > 0;) {
+        Buffer& b   = s.buffers[i];
+        b.pool      = this;
+        b.bytes     = base + i * bytes_per_buffer;
+        b.next_free = free_list;
+        free_list   = &b;
+    }
+
+    slabs.push_back(std::move(s));
+    return true;
+}
+
+PacketRef PacketPool::acquire() {
+    if (!free_list && !grow()) {
+        ++exhausted;
+        return PacketRef();
+    }
+
+    Buffer* b = free_list;
+    free_list    = b->next_free;
+    b->next_free = nullptr;
+    b->refs      = 1;
+
+    if (++in_use > peak)
+        peak = in_use;
+
+    return PacketRef(b, 0, 0);
+}
+
+PacketRef PacketPool::copy(const void* data, size_t size) {
+    if (size > bytes_per_buffer)
+        return PacketRef();
+
+    PacketRef ref = acquire();
+    if (ref) {
+        std::memcpy(ref.data(), data, size);
+        ref.resize(size);
+    }
+    return ref;
+}
+
+void PacketPool::release(Buffer* b) {
+    b->next_free = free_list;
+    free_list    = b;
+    --in_use;
+}
+
+PacketPoolStats PacketPool::stats() const {
+    PacketPoolStats s;
+    s.capacity  = slabs.size() * slab_size;
+    s.in_use    = in_use;
+    s.peak      = peak;
+    s.exhausted = exhausted;
+    return s;
+}
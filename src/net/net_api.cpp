@@ -2,15 +2,28 @@
 #include "sentinel/net/transport/udp_socket.hpp"
 
 #include <memory>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
 static std::unique_ptr<UdpSocket> sock;
 
 bool net_init(const char* host, uint16_t port) {
-    sock.reset(UdpSocket::create(host, port));
+    // SENTINEL_UDP_BACKEND=io_uring swaps the transport without a rebuild
+    UdpBackend backend = UdpBackend::SYSCALL;
+    if (const char* name = std::getenv("SENTINEL_UDP_BACKEND")) {
+        if (!udp_backend_from_name(name, backend))
+            printf("[net] unknown SENTINEL_UDP_BACKEND '%s'\n", name);
+    }
+
+    sock.reset(UdpSocket::create(host, port, backend));
     return sock != nullptr;
 }
 
+void net_init_socket(UdpSocket* socket) {
+    sock.reset(socket);
+}
+
 void net_shutdown() {
     sock.reset();
 }
@@ -27,6 +40,16 @@ ssize_t net_recv_raw_from(void* out, size_t max,
     return sock->recv_from(out, max, from);
 }
 
+int net_send_raw_batch(std::span<const OutPacket> packets) {
+    if (!sock) return -1;
+    return sock->send_batch(packets);
+}
+
+int net_recv_raw_batch(std::span<InPacket> packets) {
+    if (!sock) return -1;
+    return sock->recv_batch(packets);
+}
+
 bool net_send_snapshot_to(const Snapshot& s,
                            const sockaddr_in& addr) {
     return net_send_raw_to(&s, sizeof(s), addr) == sizeof(s);
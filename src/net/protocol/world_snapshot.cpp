@@ -0,0 +1,290 @@
+#include "sentinel/net/protocol/world_snapshot.hpp"
+#include "sentinel/net/protocol/bitstream.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+// ------------------------------------------------------------
+// Field quantization (order matches the ENTITY_FIELD_* bits)
+// ------------------------------------------------------------
+static constexpr int FIELD_COUNT = 8;
+
+static const QuantRange& field_range(const SnapshotQuantization& q, int f) {
+    switch (f) {
+    case 0:  return q.x;
+    case 1:  return q.y;
+    case 2:  return q.z;
+    case 4:  return q.pitch;
+    default: return q.vel; // 5..7
+    }
+}
+
+static int field_bits(const SnapshotQuantization& q, int f) {
+    return f == 3 ? q.yaw_bits : field_range(q, f).bits;
+}
+
+static void quantize_entity(const EntityState& e,
+                            const SnapshotQuantization& q,
+                            uint32_t out[FIELD_COUNT]) {
+    out[0] = quantize(e.x, q.x);
+    out[1] = quantize(e.y, q.y);
+    out[2] = quantize(e.z, q.z);
+    out[3] = quantize_angle(e.yaw, q.yaw_bits);
+    out[4] = quantize(e.pitch, q.pitch);
+    out[5] = quantize(e.vx, q.vel);
+    out[6] = quantize(e.vy, q.vel);
+    out[7] = quantize(e.vz, q.vel);
+}
+
+static void set_field(EntityState& e, int f, uint32_t v,
+                      const SnapshotQuantization& q) {
+    switch (f) {
+    case 0: e.x     = dequantize(v, q.x);     break;
+    case 1: e.y     = dequantize(v, q.y);     break;
+    case 2: e.z     = dequantize(v, q.z);     break;
+    case 3: e.yaw   = dequantize_angle(v, q.yaw_bits); break;
+    case 4: e.pitch = dequantize(v, q.pitch); break;
+    case 5: e.vx    = dequantize(v, q.vel);   break;
+    case 6: e.vy    = dequantize(v, q.vel);   break;
+    case 7: e.vz    = dequantize(v, q.vel);   break;
+    }
+}
+
+static size_t record_max_bits(const SnapshotQuantization& q) {
+    size_t bits = 1 + 32 + 8;
+    for (int f = 0; f < FIELD_COUNT; ++f)
+        bits += size_t(field_bits(q, f));
+    return bits;
+}
+
+static uint8_t delta_mask(const uint32_t cur_q[FIELD_COUNT],
+                          const EntityState* base,
+                          const SnapshotQuantization& q) {
+    if (!base)
+        return ENTITY_FIELD_ALL;
+
+    uint32_t base_q[FIELD_COUNT];
+    quantize_entity(*base, q, base_q);
+
+    uint8_t mask = 0;
+    for (int f = 0; f < FIELD_COUNT; ++f) {
+        if (cur_q[f] != base_q[f])
+            mask |= uint8_t(1u << f);
+    }
+    return mask;
+}
+
+static constexpr size_t BODY_BYTES =
+    WORLD_SNAPSHOT_MTU - sizeof(WorldSnapshotHeader);
+
+const EntityState* find_entity(const EntityState* list, size_t count,
+                               uint32_t player_id) {
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (list[mid].player_id < player_id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < count && list[lo].player_id == player_id)
+        return &list[lo];
+
+    return nullptr;
+}
+
+// ------------------------------------------------------------
+// Encode
+// ------------------------------------------------------------
+size_t encode_world_snapshot(uint32_t tick, uint8_t tick_rate,
+                             const EntityState* current, size_t count,
+                             uint32_t baseline_tick,
+                             const EntityState* baseline, size_t baseline_count,
+                             std::vector<WorldPacket>& out,
+                             size_t* entities_written,
+                             const SnapshotQuantization& q) {
+    const size_t max_bits = record_max_bits(q);
+
+    size_t parts = 0;
+    size_t i = 0;
+
+    while (i < count && parts < WORLD_SNAPSHOT_MAX_PARTS) {
+        if (parts == out.size())
+            out.emplace_back();
+
+        WorldPacket& p = out[parts];
+        BitWriter w(p.bytes + sizeof(WorldSnapshotHeader), BODY_BYTES);
+
+        uint32_t prev_id = 0;
+        uint16_t in_part = 0;
+
+        for (; i < count && w.bits_free() >= max_bits; ++i) {
+            const EntityState& e = current[i];
+
+            uint32_t cur_q[FIELD_COUNT];
+            quantize_entity(e, q, cur_q);
+
+            const EntityState* base =
+                baseline_tick ? find_entity(baseline, baseline_count, e.player_id)
+                              : nullptr;
+
+            uint8_t mask = delta_mask(cur_q, base, q);
+
+            bool sequential = e.player_id == prev_id + 1;
+            w.write_bool(sequential);
+            if (!sequential)
+                w.write(e.player_id, 32);
+
+            w.write(mask, 8);
+
+            for (int f = 0; f < FIELD_COUNT; ++f) {
+                if (mask & (1u << f))
+                    w.write(cur_q[f], field_bits(q, f));
+            }
+
+            prev_id = e.player_id;
+            ++in_part;
+        }
+
+        w.flush();
+
+        WorldSnapshotHeader hdr{};
+        hdr.tick = tick;
+        hdr.baseline_tick = baseline_tick;
+        hdr.entity_count = in_part;
+        hdr.part_index = uint8_t(parts);
+        hdr.tick_rate = tick_rate;
+        std::memcpy(p.bytes, &hdr, sizeof(hdr));
+
+        p.size = sizeof(WorldSnapshotHeader) + w.bytes_written();
+        ++parts;
+    }
+
+    // part_count is only known once every part is laid out
+    for (size_t k = 0; k < parts; ++k)
+        out[k].bytes[offsetof(WorldSnapshotHeader, part_count)] = uint8_t(parts);
+
+    if (entities_written)
+        *entities_written = i;
+
+    return parts;
+}
+
+size_t world_record_bits(const EntityState& e, const EntityState* base,
+                         const SnapshotQuantization& q) {
+    uint32_t cur_q[FIELD_COUNT];
+    quantize_entity(e, q, cur_q);
+
+    uint8_t mask = delta_mask(cur_q, base, q);
+
+    size_t bits = 1 + 32 + 8;
+    for (int f = 0; f < FIELD_COUNT; ++f) {
+        if (mask & (1u << f))
+            bits += size_t(field_bits(q, f));
+    }
+    return bits;
+}
+
+size_t world_snapshot_max_bytes(size_t record_bits,
+                                const SnapshotQuantization& q) {
+    if (record_bits == 0)
+        return 0;
+
+    // A part is closed once a worst-case record no longer fits, so
+    // every part but the last carries at least this much
+    const size_t per_part = BODY_BYTES * 8 - record_max_bits(q);
+    const size_t parts = (record_bits + per_part - 1) / per_part;
+
+    return parts * sizeof(WorldSnapshotHeader) + (record_bits + 7) / 8 + parts;
+}
+
+// ------------------------------------------------------------
+// Decode
+// ------------------------------------------------------------
+bool read_world_snapshot_header(const uint8_t* data, size_t size,
+                                WorldSnapshotHeader& out) {
+    if (size < sizeof(WorldSnapshotHeader) || size > WORLD_SNAPSHOT_MTU)
+        return false;
+
+    std::memcpy(&out, data, sizeof(out));
+
+    if (out.hdr.type != PacketType::WORLD_SNAPSHOT ||
+        out.hdr.version != PROTOCOL_VERSION)
+        return false;
+
+    if (out.tick == 0 || out.tick_rate == 0 || out.part_count == 0 ||
+        out.part_count > WORLD_SNAPSHOT_MAX_PARTS ||
+        out.part_index >= out.part_count)
+        return false;
+
+    return true;
+}
+
+static bool decode_records(const uint8_t* data, size_t size,
+                           const WorldSnapshotHeader& hdr,
+                           const EntityState* baseline, size_t baseline_count,
+                           std::vector<EntityState>& out,
+                           const SnapshotQuantization& q) {
+    BitReader r(data + sizeof(WorldSnapshotHeader),
+                size - sizeof(WorldSnapshotHeader));
+
+    uint32_t prev_id = 0;
+
+    for (uint16_t i = 0; i < hdr.entity_count; ++i) {
+        bool sequential = false;
+        if (!r.read_bool(sequential))
+            return false;
+
+        uint32_t id = prev_id + 1;
+        if (!sequential && !r.read(id, 32))
+            return false;
+
+        uint32_t mask = 0;
+        if (!r.read(mask, 8))
+            return false;
+
+        EntityState e{};
+
+        if (mask != ENTITY_FIELD_ALL) {
+            const EntityState* base = find_entity(baseline, baseline_count, id);
+            if (!hdr.baseline_tick || !base)
+                return false;
+
+            e = *base;
+        }
+
+        e.player_id = id;
+
+        for (int f = 0; f < FIELD_COUNT; ++f) {
+            if (!(mask & (1u << f)))
+                continue;
+
+            uint32_t v = 0;
+            if (!r.read(v, field_bits(q, f)))
+                return false;
+
+            set_field(e, f, v, q);
+        }
+
+        out.push_back(e);
+        prev_id = id;
+    }
+
+    // Only the final byte's zero padding may be left over
+    return sizeof(WorldSnapshotHeader) + r.bytes_read() == size;
+}
+
+bool decode_world_snapshot(const uint8_t* data, size_t size,
+                           const WorldSnapshotHeader& hdr,
+                           const EntityState* baseline, size_t baseline_count,
+                           std::vector<EntityState>& out,
+                           const SnapshotQuantization& q) {
+    size_t first = out.size();
+
+    if (decode_records(data, size, hdr, baseline, baseline_count, out, q))
+        return true;
+
+    out.resize(first);
+    return false;
+}
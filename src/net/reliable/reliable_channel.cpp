@@ -0,0 +1,271 @@
+#include "sentinel/net/reliable/reliable_channel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Resend tuning: smoothed RTT plus four deviations, as TCP does. Acks
+// wait for the peer's next tick, so the deviation is rarely small.
+static constexpr double RESEND_DEFAULT = 0.25; // before any RTT sample
+static constexpr double RESEND_MIN     = 0.05;
+static constexpr double RESEND_MAX     = 1.0;
+static constexpr double RTT_GAIN       = 0.125;
+static constexpr double RTTVAR_GAIN    = 0.25;
+
+static_assert((RELIABLE_WINDOW & (RELIABLE_WINDOW - 1)) == 0,
+              "reliable window must be a power of two");
+static_assert(RELIABLE_WINDOW <= 32, "sent packets track ids in 32 bits");
+
+// Sequence numbers wrap; a is newer when it is less than half the
+// space ahead of b
+static bool seq_newer(uint16_t a, uint16_t b) {
+    return int16_t(uint16_t(a - b)) > 0;
+}
+
+double ReliableChannel::resend_timeout() const {
+    if (srtt <= 0.0)
+        return RESEND_DEFAULT;
+    return std::clamp(srtt + 4.0 * rttvar, RESEND_MIN, RESEND_MAX);
+}
+
+// ------------------------------------------------------------
+// Outgoing
+// ------------------------------------------------------------
+bool ReliableChannel::send(const void* data, size_t size,
+                           ReliableStats& stats) {
+    return queue(data, nullptr, size, stats);
+}
+
+bool ReliableChannel::send(const PacketRef& msg, ReliableStats& stats) {
+    return queue(nullptr, &msg, msg.size(), stats);
+}
+
+bool ReliableChannel::queue(const void* data, const PacketRef* msg,
+                            size_t size, ReliableStats& stats) {
+    if (size > RELIABLE_MAX_MESSAGE ||
+        uint16_t(out_next - out_oldest) >= RELIABLE_WINDOW) {
+        ++stats.dropped;
+        return false;
+    }
+
+    Outgoing& m = out[out_next % RELIABLE_WINDOW];
+    m.id      = out_next;
+    m.size    = uint16_t(size);
+    m.live    = true;
+    m.sent_at = -1.0;
+
+    if (msg) {
+        m.ref = *msg;
+    } else {
+        m.ref.reset();
+        std::memcpy(m.bytes, data, size);
+    }
+
+    ++out_next;
+    return true;
+}
+
+size_t ReliableChannel::write(uint8_t* data, size_t capacity, double now,
+                              ReliableStats& stats) {
+    if (idle() || capacity < sizeof(ReliablePacket))
+        return 0;
+
+    const double timeout = resend_timeout();
+
+    ReliablePacket hdr{};
+    hdr.seq  = out_seq;
+    hdr.acks = acks();
+
+    size_t   pos  = sizeof(hdr);
+    uint32_t mask = 0;
+
+    for (uint16_t id = out_oldest; id != out_next; ++id) {
+        Outgoing& m = out[id % RELIABLE_WINDOW];
+        if (!m.live)
+            continue;
+        if (m.sent_at >= 0.0 && now - m.sent_at < timeout)
+            continue;
+
+        const size_t need = sizeof(ReliableRecord) + m.size;
+        if (pos + need > capacity)
+            break;
+
+        ReliableRecord rec{};
+        rec.id   = m.id;
+        rec.size = m.size;
+        std::memcpy(data + pos, &rec, sizeof(rec));
+        std::memcpy(data + pos + sizeof(rec), m.data(), m.size);
+        pos += need;
+
+        if (m.sent_at >= 0.0)
+            ++stats.resent;
+        m.sent_at = now;
+
+        mask |= 1u << uint16_t(id - out_oldest);
+        ++hdr.count;
+    }
+
+    if (hdr.count == 0)
+        return 0;
+
+    std::memcpy(data, &hdr, sizeof(hdr));
+
+    Sent& p = sent[out_seq % SENT_HISTORY];
+    p.seq  = out_seq;
+    p.live = true;
+    p.time = now;
+    p.base = out_oldest;
+    p.mask = mask;
+
+    ++out_seq;
+    return pos;
+}
+
+void ReliableChannel::on_ack(const ReliableAck& a, double now) {
+    for (uint32_t i = 0; i < 32; ++i) {
+        if (!(a.bits & (1u << i)))
+            continue;
+
+        const uint16_t seq = uint16_t(a.ack - i);
+        Sent& p = sent[seq % SENT_HISTORY];
+        if (!p.live || p.seq != seq)
+            continue;
+
+        p.live = false;
+
+        // Older bits may be repeats of a lost ack; only the newest
+        // packet times the round trip
+        if (i == 0) {
+            const double sample = now - p.time;
+            if (srtt <= 0.0) {
+                srtt   = sample;
+                rttvar = sample * 0.5;
+            } else {
+                rttvar += (std::fabs(sample - srtt) - rttvar) * RTTVAR_GAIN;
+                srtt   += (sample - srtt) * RTT_GAIN;
+            }
+        }
+
+        for (uint16_t k = 0; k < RELIABLE_WINDOW; ++k) {
+            if (!(p.mask & (1u << k)))
+                continue;
+
+            const uint16_t id = uint16_t(p.base + k);
+            Outgoing& m = out[id % RELIABLE_WINDOW];
+            if (m.id == id) {
+                m.live = false;
+                m.ref.reset(); // the last channel to ack frees it
+            }
+        }
+    }
+
+    while (!idle() && !out[out_oldest % RELIABLE_WINDOW].live)
+        ++out_oldest;
+}
+
+// ------------------------------------------------------------
+// Incoming
+// ------------------------------------------------------------
+bool ReliableChannel::receive(const uint8_t* data, size_t size, double now) {
+    return take(data, size, nullptr, now);
+}
+
+bool ReliableChannel::receive(const PacketRef& packet, double now) {
+    return take(packet.data(), packet.size(), &packet, now);
+}
+
+bool ReliableChannel::take(const uint8_t* data, size_t size,
+                           const PacketRef* packet, double now) {
+    ReliablePacket hdr{};
+    if (size < sizeof(hdr))
+        return false;
+    std::memcpy(&hdr, data, sizeof(hdr));
+
+    // Check every record fits before taking any of them
+    size_t pos = sizeof(hdr);
+    for (uint8_t k = 0; k < hdr.count; ++k) {
+        ReliableRecord rec{};
+        if (pos + sizeof(rec) > size)
+            return false;
+        std::memcpy(&rec, data + pos, sizeof(rec));
+
+        pos += sizeof(rec) + rec.size;
+        if (rec.size > RELIABLE_MAX_MESSAGE || pos > size)
+            return false;
+    }
+
+    on_ack(hdr.acks, now);
+
+    // Track the packet for our acks
+    if (in_bits == 0) {
+        in_seq  = hdr.seq;
+        in_bits = 1;
+    } else if (seq_newer(hdr.seq, in_seq)) {
+        const uint16_t shift = uint16_t(hdr.seq - in_seq);
+        in_bits = shift >= 32 ? 1u : (in_bits << shift) | 1u;
+        in_seq  = hdr.seq;
+    } else {
+        const uint16_t back = uint16_t(in_seq - hdr.seq);
+        if (back < 32)
+            in_bits |= 1u << back;
+    }
+
+    // Keep messages inside the window; older ones were delivered
+    pos = sizeof(hdr);
+    for (uint8_t k = 0; k < hdr.count; ++k) {
+        ReliableRecord rec{};
+        std::memcpy(&rec, data + pos, sizeof(rec));
+        pos += sizeof(rec);
+
+        Incoming& m = in[rec.id % RELIABLE_WINDOW];
+        if (uint16_t(rec.id - in_next) < RELIABLE_WINDOW &&
+            !(m.present && m.id == rec.id)) {
+            m.id      = rec.id;
+            m.size    = rec.size;
+            m.present = true;
+
+            if (packet) {
+                m.ref = packet->slice(pos, rec.size);
+            } else {
+                m.ref.reset();
+                std::memcpy(m.bytes, data + pos, rec.size);
+            }
+        }
+
+        pos += rec.size;
+    }
+
+    return true;
+}
+
+bool ReliableChannel::pop(const uint8_t*& data, size_t& size) {
+    Incoming& m = in[in_next % RELIABLE_WINDOW];
+    if (!m.present || m.id != in_next)
+        return false;
+
+    m.present = false;
+    data = m.data();
+    size = m.size;
+
+    ++in_next;
+    return true;
+}
+
+bool ReliableChannel::pop(PacketRef& msg) {
+    Incoming& m = in[in_next % RELIABLE_WINDOW];
+    if (!m.present || m.id != in_next)
+        return false;
+
+    m.present = false;
+    msg = std::move(m.ref);
+
+    ++in_next;
+    return true;
+}
+
+ReliableAck ReliableChannel::acks() const {
+    ReliableAck a{};
+    a.ack  = in_seq;
+    a.bits = in_bits;
+    return a;
+}
@@ -1,9 +1,101 @@
 #include "sentinel/net/replication/replication_client.hpp"
+#include "sentinel/net/protocol/world_snapshot.hpp"
+
+#include <algorithm>
 
 void ReplicationClient::ingest(const Snapshot& s) {
     players[s.player_id].push(s);
 }
 
+const ReplicationClient::WorldFrame*
+ReplicationClient::complete_frame(uint32_t tick) const {
+    const WorldFrame& f = frames[tick % FRAME_HISTORY];
+    if (f.tick != tick || !f.complete)
+        return nullptr;
+
+    return &f;
+}
+
+bool ReplicationClient::ingest(const uint8_t* data, size_t size,
+                               double now) {
+    WorldSnapshotHeader hdr{};
+    if (!read_world_snapshot_header(data, size, hdr))
+        return false;
+
+    const EntityState* base = nullptr;
+    size_t base_count = 0;
+
+    if (hdr.baseline_tick) {
+        const WorldFrame* b = complete_frame(hdr.baseline_tick);
+        if (!b)
+            return true; // baseline evicted or never completed
+
+        base = b->entities.data();
+        base_count = b->entities.size();
+    }
+
+    WorldFrame& f = frames[hdr.tick % FRAME_HISTORY];
+    if (f.tick != hdr.tick) {
+        if (f.tick > hdr.tick)
+            return true; // late part of a tick already overwritten
+
+        f.tick = hdr.tick;
+        f.baseline_tick = hdr.baseline_tick;
+        f.part_count = hdr.part_count;
+        f.parts_seen = 0;
+        f.complete = false;
+        f.entities.clear();
+    }
+
+    uint64_t bit = uint64_t(1) << hdr.part_index;
+    if (f.complete || (f.parts_seen & bit))
+        return true; // duplicate
+
+    size_t first = f.entities.size();
+    if (!decode_world_snapshot(data, size, hdr, base, base_count, f.entities))
+        return true;
+
+    f.parts_seen |= bit;
+    rate = hdr.tick_rate;
+
+    if (hdr.tick > newest_tick) {
+        newest_tick = hdr.tick;
+        newest_arrival = now;
+    }
+
+    double server_time = double(hdr.tick) / hdr.tick_rate;
+
+    for (size_t i = first; i < f.entities.size(); ++i)
+        ingest(snapshot_from_entity(f.entities[i], hdr.tick, server_time));
+
+    if (f.parts_seen == (uint64_t(-1) >> (64 - f.part_count))) {
+        std::sort(f.entities.begin(), f.entities.end(),
+            [](const EntityState& a, const EntityState& b) {
+                return a.player_id < b.player_id;
+            });
+
+        f.complete = true;
+        newest_complete = std::max(newest_complete, f.tick);
+    }
+
+    return true;
+}
+
+bool ReplicationClient::take_ack(uint32_t& tick) {
+    if (newest_complete == last_acked)
+        return false;
+
+    tick = last_acked = newest_complete;
+    return true;
+}
+
+double ReplicationClient::render_time(double now, double delay) const {
+    if (rate == 0)
+        return -1.0;
+
+    return double(newest_tick) / rate + (now - newest_arrival) - delay;
+}
+
 bool ReplicationClient::sample(uint32_t id, double t,
                                Snapshot& a, Snapshot& b) {
     auto it = players.find(id);
@@ -12,3 +104,9 @@ bool ReplicationClient::sample(uint32_t id, double t,
 
     return it->second.sample(t, a, b);
 }
+
+void ReplicationClient::player_ids(std::vector<uint32_t>& out) const {
+    out.clear();
+    for (const auto& [id, _] : players)
+        out.push_back(id);
+}
@@ -0,0 +1,306 @@
+#include "sentinel/net/transport/sim_network.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+
+// Datagrams a socket holds before new ones are dropped, as a full
+// receive buffer would
+static constexpr size_t SIM_INBOX_DATAGRAMS = 4096;
+
+// Pareto jitter: tail index and cap, in multiples of `jitter`
+static constexpr double SIM_PARETO_ALPHA = 2.0;
+static constexpr double SIM_PARETO_CAP   = 50.0;
+
+// ------------------------------------------------------------
+// Endpoint
+// ------------------------------------------------------------
+class SimNetwork::Endpoint final : public UdpSocket {
+public:
+    Endpoint(SimNetwork& net, uint64_t address)
+        : net(net), self(address) {}
+
+    ~Endpoint() override { net.close(self); }
+
+    ssize_t send_to(const void* data, size_t size,
+                    const sockaddr_in& to) override {
+        net.send(self, key(to), data, size);
+        return ssize_t(size);
+    }
+
+    ssize_t recv_from(void* out, size_t max, sockaddr_in& from) override {
+        if (inbox.empty())
+            return -1;
+
+        Arrived& a = inbox.front();
+        const size_t n = std::min(a.bytes.size(), max); // truncates, as UDP does
+        std::memcpy(out, a.bytes.data(), n);
+        from = from_key(a.from);
+        inbox.pop_front();
+
+        last_peer = from; // remember for send_bytes
+        has_peer  = true;
+        return ssize_t(n);
+    }
+
+    ssize_t send_bytes(const void* data, size_t size) override {
+        if (!has_peer)
+            return -1;
+
+        return send_to(data, size, last_peer);
+    }
+
+    ssize_t recv_bytes(void* out, size_t max) override {
+        sockaddr_in from{};
+        return recv_from(out, max, from);
+    }
+
+    // Called by the network as datagrams come due
+    bool deliver(uint64_t from, std::vector<uint8_t>&& bytes) {
+        if (inbox.size() >= SIM_INBOX_DATAGRAMS)
+            return false;
+
+        inbox.push_back(Arrived{ from, std::move(bytes) });
+        return true;
+    }
+
+    uint64_t address() const { return self; }
+
+private:
+    struct Arrived {
+        uint64_t             from;
+        std::vector<uint8_t> bytes;
+    };
+
+    SimNetwork& net;
+    uint64_t    self;
+
+    std::deque<Arrived> inbox;
+
+    sockaddr_in last_peer{};
+    bool has_peer = false;
+};
+
+// ------------------------------------------------------------
+// Network
+// ------------------------------------------------------------
+SimNetwork::SimNetwork(uint64_t seed) : rng(seed) {}
+
+SimNetwork::~SimNetwork() = default;
+
+uint64_t SimNetwork::key(const sockaddr_in& a) {
+    return (uint64_t(ntohl(a.sin_addr.s_addr)) << 16) | ntohs(a.sin_port);
+}
+
+sockaddr_in SimNetwork::from_key(uint64_t k) {
+    sockaddr_in a{};
+    a.sin_family      = AF_INET;
+    a.sin_addr.s_addr = htonl(uint32_t(k >> 16));
+    a.sin_port        = htons(uint16_t(k));
+    return a;
+}
+
+UdpSocket* SimNetwork::create(const char* host, uint16_t port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1)
+        return nullptr;
+
+    if (port == 0) {
+        // Ephemeral range, wrapping; gives up after one lap
+        for (uint32_t tries = 0; tries < 16384 && port == 0; ++tries) {
+            addr.sin_port = htons(next_port);
+            if (!endpoints.count(key(addr)))
+                port = next_port;
+            next_port = next_port == 65535 ? 49152 : uint16_t(next_port + 1);
+        }
+        if (port == 0)
+            return nullptr;
+    }
+
+    addr.sin_port = htons(port);
+    const uint64_t k = key(addr);
+    if (endpoints.count(k))
+        return nullptr;
+
+    Endpoint* e = new Endpoint(*this, k);
+    endpoints[k] = e;
+    return e;
+}
+
+sockaddr_in SimNetwork::address(const UdpSocket* socket) {
+    return from_key(static_cast<const Endpoint*>(socket)->address());
+}
+
+void SimNetwork::close(uint64_t address) {
+    endpoints.erase(address);
+}
+
+void SimNetwork::set_default_link(const SimLinkConfig& config) {
+    default_link = config;
+}
+
+void SimNetwork::set_link(const sockaddr_in& from, const sockaddr_in& to,
+                          const SimLinkConfig& config) {
+    link(key(from), key(to)).config = config;
+}
+
+void SimNetwork::set_path(const sockaddr_in& a, const sockaddr_in& b,
+                          const SimLinkConfig& config) {
+    set_link(a, b, config);
+    set_link(b, a, config);
+}
+
+SimNetwork::Link& SimNetwork::link(uint64_t from, uint64_t to) {
+    auto [it, added] = links.try_emplace(LinkKey{ from, to });
+    if (added)
+        it->second.config = default_link;
+    return it->second;
+}
+
+SimLinkStats SimNetwork::link_stats(const sockaddr_in& from,
+                                    const sockaddr_in& to) const {
+    auto it = links.find(LinkKey{ key(from), key(to) });
+    return it == links.end() ? SimLinkStats{} : it->second.stats;
+}
+
+SimLinkStats SimNetwork::stats() const {
+    SimLinkStats sum;
+    for (const auto& [k, l] : links) {
+        sum.sent       += l.stats.sent;
+        sum.delivered  += l.stats.delivered;
+        sum.lost       += l.stats.lost;
+        sum.queue_drop += l.stats.queue_drop;
+        sum.recv_drop  += l.stats.recv_drop;
+        sum.duplicated += l.stats.duplicated;
+        sum.reordered  += l.stats.reordered;
+        sum.bytes      += l.stats.bytes;
+    }
+    return sum;
+}
+
+// ---- sending ----
+void SimNetwork::send(uint64_t from, uint64_t to,
+                      const void* data, size_t size) {
+    Link& l = link(from, to);
+    const SimLinkConfig& c = l.config;
+    l.stats.sent++;
+
+    if (c.loss > 0.0 && uniform() < c.loss) {
+        l.stats.lost++;
+        return;
+    }
+
+    // Time the last byte leaves the sender
+    double departs = clock;
+    if (c.bandwidth > 0.0) {
+        const double start  = std::max(clock, l.busy_until);
+        const double queued = (start - clock) * c.bandwidth;
+        if (queued + double(size) > double(c.queue_bytes) && queued > 0.0) {
+            l.stats.queue_drop++;
+            return;
+        }
+
+        l.busy_until = start + double(size) / c.bandwidth;
+        departs = l.busy_until;
+    }
+
+    const bool twice = c.duplicate > 0.0 && uniform() < c.duplicate;
+    if (twice)
+        l.stats.duplicated++;
+
+    for (int copy = 0; copy < (twice ? 2 : 1); ++copy) {
+        double at = departs + delay(c);
+
+        if (c.reorder > 0.0 && uniform() < c.reorder) {
+            at += c.reorder_delay;
+            l.stats.reordered++;
+        } else {
+            at = std::max(at, l.last_arrival);
+            l.last_arrival = at;
+        }
+
+        Datagram d;
+        d.at   = at;
+        d.seq  = sends++;
+        d.from = from;
+        d.to   = to;
+        d.bytes.assign((const uint8_t*)data, (const uint8_t*)data + size);
+        flight.push(std::move(d));
+    }
+}
+
+double SimNetwork::delay(const SimLinkConfig& c) {
+    if (c.jitter <= 0.0)
+        return c.latency;
+
+    double j = 0.0;
+    switch (c.jitter_shape) {
+    case SimJitter::UNIFORM:
+        j = uniform() * c.jitter;
+        break;
+
+    case SimJitter::NORMAL: {
+        // Box-Muller; 1 - uniform() keeps the log away from 0
+        const double u1 = 1.0 - uniform();
+        const double u2 = uniform();
+        j = std::fabs(std::sqrt(-2.0 * std::log(u1)) *
+                      std::cos(6.283185307179586 * u2)) * c.jitter;
+        break;
+    }
+
+    case SimJitter::PARETO: {
+        const double u = 1.0 - uniform();
+        j = c.jitter * (std::pow(u, -1.0 / SIM_PARETO_ALPHA) - 1.0);
+        j = std::min(j, c.jitter * SIM_PARETO_CAP);
+        break;
+    }
+    }
+
+    return c.latency + j;
+}
+
+// ---- clock ----
+void SimNetwork::advance(double seconds) {
+    advance_to(clock + seconds);
+}
+
+void SimNetwork::advance_to(double time) {
+    while (!flight.empty() && flight.top().at <= time) {
+        // top() is const; the bytes are moved out just before the pop
+        Datagram& d = const_cast<Datagram&>(flight.top());
+        clock = std::max(clock, d.at);
+
+        Link& l = link(d.from, d.to);
+        const size_t size = d.bytes.size();
+
+        auto it = endpoints.find(d.to);
+        if (it != endpoints.end() && it->second->deliver(d.from, std::move(d.bytes))) {
+            l.stats.delivered++;
+            l.stats.bytes += size;
+        } else {
+            l.stats.recv_drop++;
+        }
+
+        flight.pop();
+    }
+
+    clock = std::max(clock, time);
+}
+
+double SimNetwork::next_delivery() const {
+    return flight.empty() ? -1.0 : flight.top().at;
+}
+
+// ---- randomness ----
+uint64_t SimNetwork::next_random() {
+    uint64_t z = (rng += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+double SimNetwork::uniform() {
+    return double(next_random() >> 11) * 0x1.0p-53;
+}
@@ -1,10 +1,17 @@
 #include "sentinel/net/transport/udp_socket.hpp"
+#include "udp_uring.hpp"
 
 #include <arpa/inet.h>
+#include <sys/socket.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include <cstdio>
 
+// Datagrams per sendmmsg/recvmmsg call; longer spans take several
+static constexpr size_t MMSG_BATCH = 64;
+
 class UdpSocketLinux final : public UdpSocket {
 public:
     explicit UdpSocketLinux(uint16_t port) {
@@ -79,6 +86,93 @@ public:
         return n;
     }
 
+    // ------------------------------------------------------------
+    // Batched API: one syscall per MMSG_BATCH datagrams
+    // ------------------------------------------------------------
+
+    int send_batch(std::span<const OutPacket> packets) override {
+        if (sockfd < 0)
+            return -1;
+
+        mmsghdr msgs[MMSG_BATCH];
+        iovec   iovs[MMSG_BATCH];
+
+        size_t sent = 0;
+        while (sent < packets.size()) {
+            const size_t n = std::min(packets.size() - sent, MMSG_BATCH);
+
+            for (size_t i = 0; i < n; ++i) {
+                const OutPacket& p = packets[sent + i];
+                iovs[i].iov_base = const_cast<void*>(p.data);
+                iovs[i].iov_len  = p.size;
+
+                msgs[i] = {};
+                msgs[i].msg_hdr.msg_name    = const_cast<sockaddr_in*>(&p.to);
+                msgs[i].msg_hdr.msg_namelen = sizeof(p.to);
+                msgs[i].msg_hdr.msg_iov     = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen  = 1;
+            }
+
+            int r = sendmmsg(sockfd, msgs, unsigned(n), 0);
+            if (r <= 0)
+                return sent ? int(sent) : -1;
+
+            sent += size_t(r);
+            if (size_t(r) < n)
+                break; // the next one failed; leave it to the caller
+        }
+
+        return int(sent);
+    }
+
+    int recv_batch(std::span<InPacket> packets) override {
+        if (sockfd < 0)
+            return -1;
+
+        mmsghdr msgs[MMSG_BATCH];
+        iovec   iovs[MMSG_BATCH];
+
+        size_t got = 0;
+        while (got < packets.size()) {
+            const size_t n = std::min(packets.size() - got, MMSG_BATCH);
+
+            for (size_t i = 0; i < n; ++i) {
+                InPacket& p = packets[got + i];
+                iovs[i].iov_base = p.data;
+                iovs[i].iov_len  = p.capacity;
+
+                msgs[i] = {};
+                msgs[i].msg_hdr.msg_name    = &p.from;
+                msgs[i].msg_hdr.msg_namelen = sizeof(p.from);
+                msgs[i].msg_hdr.msg_iov     = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen  = 1;
+            }
+
+            // MSG_DONTWAIT: only what is already queued, even though the
+            // socket itself blocks for recv_from()
+            int r = recvmmsg(sockfd, msgs, unsigned(n), MSG_DONTWAIT, nullptr);
+            if (r < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                    break;
+                return got ? int(got) : -1;
+            }
+
+            for (int i = 0; i < r; ++i)
+                packets[got + size_t(i)].size = msgs[i].msg_len;
+
+            got += size_t(r);
+            if (size_t(r) < n)
+                break; // queue drained
+        }
+
+        if (got > 0) {
+            last_peer = packets[got - 1].from;
+            has_peer  = true;
+        }
+
+        return int(got);
+    }
+
     // ------------------------------------------------------------
     // Byte-stream compatibility API
     // ------------------------------------------------------------
@@ -112,7 +206,13 @@ private:
 // ------------------------------------------------------------
 // Factory
 // ------------------------------------------------------------
-UdpSocket* UdpSocket::create(const char*, uint16_t port) {
+UdpSocket* UdpSocket::create(const char*, uint16_t port, UdpBackend backend) {
+    if (backend == UdpBackend::IO_URING) {
+        if (UdpSocket* s = create_udp_uring(port))
+            return s;
+        printf("[net] io_uring unavailable, using recvfrom\n");
+    }
+
     return new UdpSocketLinux(port);
 }
 
@@ -0,0 +1,557 @@
+#include "udp_uring.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// ------------------------------------------------------------
+// io_uring UDP socket
+// ------------------------------------------------------------
+// Receive is one multishot RECVMSG: the kernel picks one of our
+// provided buffers for every datagram and posts a completion, so a
+// busy socket costs no syscall per packet. recv_from() only enters the
+// kernel when no completion is waiting, and read buffers go back to
+// the kernel in runs, riding along with the next submission.
+//
+// Buffers are a classic PROVIDE_BUFFERS group rather than a registered
+// buffer ring: on the 6.18 kernel this was tested on, a ring registers
+// but every receive from it fails with ENOBUFS. Multishot consumes
+// either kind the same way.
+//
+// send_to() copies into a slot and queues a SENDMSG. Queued sends go
+// to the kernel together: at the next recv_from(), once
+// URING_SEND_BATCH are waiting, or when slots run out. send_batch()
+// submits its whole span at once; recv_batch() enters the kernel at
+// most once and never sleeps.
+//
+// Talks to the kernel directly (no liburing). One thread only: the
+// ring is set up for a single issuer and runs completions when that
+// thread waits.
+
+static constexpr unsigned URING_SQ_ENTRIES   = 512;
+static constexpr unsigned URING_CQ_ENTRIES   = 4096; // > buffers + slots
+static constexpr unsigned URING_RECV_BUFFERS = 512;
+static constexpr size_t   URING_RECV_BYTES   = 2048; // header + name + data
+static constexpr unsigned URING_SEND_SLOTS   = 256;
+static constexpr size_t   URING_SEND_BYTES   = 2048;
+static constexpr unsigned URING_SEND_BATCH   = 64;   // submit at this many
+static constexpr uint16_t URING_BUFFER_GROUP = 0;
+
+// Sends carry their slot as user_data
+static constexpr uint64_t TAG_RECV    = ~uint64_t(0);
+static constexpr uint64_t TAG_PROVIDE = ~uint64_t(0) - 1;
+
+static int uring_setup(unsigned entries, io_uring_params* p) {
+    return int(syscall(__NR_io_uring_setup, entries, p));
+}
+
+static int uring_enter(int fd, unsigned submit, unsigned wait,
+                       unsigned flags) {
+    return int(syscall(__NR_io_uring_enter, fd, submit, wait, flags,
+                       nullptr, 0));
+}
+
+template <class T>
+static T load_acquire(const T* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+template <class T>
+static void store_release(T* p, T v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+class UdpSocketUring final : public UdpSocket {
+public:
+    ~UdpSocketUring() override {
+        if (ring_fd >= 0) {
+            // Everything send_to() accepted goes out before the close
+            while (sends_in_flight > 0 && wait(1))
+                reap();
+            close(ring_fd);
+        }
+
+        if (sq_ring != MAP_FAILED)
+            munmap(sq_ring, sq_ring_bytes);
+        if (cq_ring != MAP_FAILED && cq_ring != sq_ring)
+            munmap(cq_ring, cq_ring_bytes);
+        if (sqes != MAP_FAILED)
+            munmap(sqes, URING_SQ_ENTRIES * sizeof(io_uring_sqe));
+        if (recv_bytes_base != MAP_FAILED)
+            munmap(recv_bytes_base, URING_RECV_BUFFERS * URING_RECV_BYTES);
+
+        if (sockfd >= 0)
+            close(sockfd);
+    }
+
+    bool open(uint16_t port) {
+        sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (sockfd < 0) {
+            perror("socket");
+            return false;
+        }
+
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = INADDR_ANY;
+        addr.sin_port        = htons(port);
+
+        if (bind(sockfd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+            perror("bind");
+            return false;
+        }
+
+        return setup_ring() && setup_buffers() && arm_recv();
+    }
+
+    // ------------------------------------------------------------
+    // Address-explicit API
+    // ------------------------------------------------------------
+    ssize_t send_to(const void* data, size_t size,
+                    const sockaddr_in& to) override {
+        const ssize_t n = queue_send(data, size, to);
+        if (n >= 0 && pending_sqes >= URING_SEND_BATCH)
+            submit();
+        return n;
+    }
+
+    ssize_t recv_from(void* out, size_t max, sockaddr_in& from) override {
+        if (ready_count == 0) {
+            reap();
+
+            while (ready_count == 0) {
+                if (!recv_armed && !arm_recv())
+                    return -1;
+                if (!wait(1))
+                    return -1;
+                reap();
+            }
+        } else if (pending_sqes > 0) {
+            submit(); // sends queued since the last wait
+        }
+
+        return take(out, max, from);
+    }
+
+    // ------------------------------------------------------------
+    // Batched API
+    // ------------------------------------------------------------
+
+    // Queues the whole span and submits it with one io_uring_enter
+    int send_batch(std::span<const OutPacket> packets) override {
+        int sent = 0;
+        for (const OutPacket& p : packets) {
+            if (queue_send(p.data, p.size, p.to) < 0)
+                break;
+            ++sent;
+        }
+
+        submit();
+        return sent ? sent : (packets.empty() ? 0 : -1);
+    }
+
+    int recv_batch(std::span<InPacket> packets) override {
+        reap();
+
+        // Nothing reaped: enter once without sleeping, which submits
+        // queued sends and runs the deferred receive completions
+        if (ready_count == 0) {
+            if (!recv_armed && !arm_recv())
+                return -1;
+            if (!wait(0))
+                return -1;
+            reap();
+        } else if (pending_sqes > 0) {
+            submit();
+        }
+
+        int got = 0;
+        for (InPacket& p : packets) {
+            if (ready_count == 0)
+                break;
+            p.size = size_t(take(p.data, p.capacity, p.from));
+            ++got;
+        }
+        return got;
+    }
+
+    // ------------------------------------------------------------
+    // Byte-stream compatibility API
+    // ------------------------------------------------------------
+    ssize_t send_bytes(const void* data, size_t size) override {
+        if (!has_peer)
+            return -1;
+
+        return send_to(data, size, last_peer);
+    }
+
+    ssize_t recv_bytes(void* out, size_t max) override {
+        sockaddr_in from{};
+        return recv_from(out, max, from);
+    }
+
+private:
+    struct SendSlot {
+        msghdr      hdr;
+        iovec       iov;
+        sockaddr_in to;
+        uint8_t     bytes[URING_SEND_BYTES];
+    };
+
+    struct Ready {
+        uint16_t buffer;
+        uint32_t length; // bytes the kernel wrote, header included
+    };
+
+    // ---- send ----
+    // Copies into a free slot and queues a SENDMSG; submitting is up to
+    // the caller
+    ssize_t queue_send(const void* data, size_t size, const sockaddr_in& to) {
+        // Too big for a slot; rare enough to send directly
+        if (size > URING_SEND_BYTES)
+            return sendto(sockfd, data, size, 0, (const sockaddr*)&to,
+                          sizeof(to));
+
+        while (free_slot_count == 0) {
+            reap();
+            if (free_slot_count == 0 && !wait(1))
+                return -1;
+        }
+
+        io_uring_sqe* sqe = next_sqe();
+        if (!sqe)
+            return -1;
+
+        const uint32_t i = free_slots[--free_slot_count];
+        SendSlot& slot = slots[i];
+
+        std::memcpy(slot.bytes, data, size);
+        slot.to           = to;
+        slot.iov.iov_base = slot.bytes;
+        slot.iov.iov_len  = size;
+        slot.hdr          = msghdr{};
+        slot.hdr.msg_name    = &slot.to;
+        slot.hdr.msg_namelen = sizeof(slot.to);
+        slot.hdr.msg_iov     = &slot.iov;
+        slot.hdr.msg_iovlen  = 1;
+
+        sqe->opcode    = IORING_OP_SENDMSG;
+        sqe->fd        = sockfd;
+        sqe->addr      = uint64_t(uintptr_t(&slot.hdr));
+        sqe->len       = 1;
+        sqe->user_data = i;
+
+        ++sends_in_flight;
+        return ssize_t(size);
+    }
+
+    // ---- receive ----
+    // Copies out the oldest ready datagram; ready_count must be > 0
+    ssize_t take(void* out, size_t max, sockaddr_in& from) {
+        const Ready r = ready[ready_head];
+        ready_head = (ready_head + 1) % URING_RECV_BUFFERS;
+        --ready_count;
+
+        uint8_t* buf = recv_buffer(r.buffer);
+        io_uring_recvmsg_out msg_out;
+        std::memcpy(&msg_out, buf, sizeof(msg_out));
+
+        const uint8_t* name    = buf + sizeof(msg_out);
+        const uint8_t* payload = name + sizeof(sockaddr_in);
+
+        // Anything past the buffer was cut off by the kernel
+        size_t n = msg_out.payloadlen;
+        const size_t held = r.length - sizeof(msg_out) - sizeof(sockaddr_in);
+        if (n > held) n = held;
+        if (n > max)  n = max;
+
+        from = sockaddr_in{};
+        std::memcpy(&from, name, msg_out.namelen < sizeof(from)
+                                     ? msg_out.namelen : sizeof(from));
+        std::memcpy(out, payload, n);
+
+        recycle(r.buffer);
+
+        last_peer = from; // remember for send_bytes
+        has_peer  = true;
+        return ssize_t(n);
+    }
+
+    // ---- setup ----
+    bool setup_ring() {
+        io_uring_params p{};
+        p.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER |
+                  IORING_SETUP_DEFER_TASKRUN;
+        p.cq_entries = URING_CQ_ENTRIES;
+
+        ring_fd = uring_setup(URING_SQ_ENTRIES, &p);
+        if (ring_fd < 0 && errno == EINVAL) {
+            // Kernels before 6.1 lack the single-issuer flags
+            p = io_uring_params{};
+            p.flags = IORING_SETUP_CQSIZE;
+            p.cq_entries = URING_CQ_ENTRIES;
+            ring_fd = uring_setup(URING_SQ_ENTRIES, &p);
+        }
+        if (ring_fd < 0) {
+            perror("io_uring_setup");
+            return false;
+        }
+
+        sq_ring_bytes = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_ring_bytes = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+
+        const bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) {
+            if (cq_ring_bytes > sq_ring_bytes)
+                sq_ring_bytes = cq_ring_bytes;
+            cq_ring_bytes = sq_ring_bytes;
+        }
+
+        sq_ring = mmap(nullptr, sq_ring_bytes, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+        if (sq_ring == MAP_FAILED)
+            return false;
+
+        cq_ring = single ? sq_ring
+                         : mmap(nullptr, cq_ring_bytes, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, ring_fd,
+                                IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED)
+            return false;
+
+        sqes = mmap(nullptr, p.sq_entries * sizeof(io_uring_sqe),
+                    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring_fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+            return false;
+
+        uint8_t* sq = (uint8_t*)sq_ring;
+        sq_head  = (unsigned*)(sq + p.sq_off.head);
+        sq_tail  = (unsigned*)(sq + p.sq_off.tail);
+        sq_mask  = *(unsigned*)(sq + p.sq_off.ring_mask);
+        sq_array = (unsigned*)(sq + p.sq_off.array);
+        sq_entries = p.sq_entries;
+        sq_local_tail = *sq_tail;
+
+        uint8_t* cq = (uint8_t*)cq_ring;
+        cq_head = (unsigned*)(cq + p.cq_off.head);
+        cq_tail = (unsigned*)(cq + p.cq_off.tail);
+        cq_mask = *(unsigned*)(cq + p.cq_off.ring_mask);
+        cqes    = (io_uring_cqe*)(cq + p.cq_off.cqes);
+
+        for (uint32_t i = 0; i < URING_SEND_SLOTS; ++i)
+            free_slots[i] = URING_SEND_SLOTS - 1 - i;
+        free_slot_count = URING_SEND_SLOTS;
+
+        return true;
+    }
+
+    bool setup_buffers() {
+        recv_bytes_base = mmap(nullptr, URING_RECV_BUFFERS * URING_RECV_BYTES,
+                               PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (recv_bytes_base == MAP_FAILED)
+            return false;
+
+        // Goes in ahead of the RECVMSG that arm_recv() queues
+        run_start = 0;
+        run_count = URING_RECV_BUFFERS;
+        return provide_run();
+    }
+
+    // Also re-arms after the kernel ends the multishot (buffers ran out
+    // or an error); datagrams that arrive meanwhile wait in the socket
+    bool arm_recv() {
+        io_uring_sqe* sqe = next_sqe();
+        if (!sqe)
+            return false;
+
+        recv_msg = msghdr{};
+        recv_msg.msg_namelen = sizeof(sockaddr_in);
+
+        sqe->opcode    = IORING_OP_RECVMSG;
+        sqe->fd        = sockfd;
+        sqe->addr      = uint64_t(uintptr_t(&recv_msg));
+        sqe->len       = 1;
+        sqe->ioprio    = IORING_RECV_MULTISHOT;
+        sqe->flags     = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = URING_BUFFER_GROUP;
+        sqe->user_data = TAG_RECV;
+
+        recv_armed = true;
+        return submit();
+    }
+
+    // ---- submission ----
+    io_uring_sqe* next_sqe() {
+        if (sq_local_tail - load_acquire(sq_head) >= sq_entries) {
+            submit();
+            if (sq_local_tail - load_acquire(sq_head) >= sq_entries)
+                return nullptr;
+        }
+
+        const unsigned idx = sq_local_tail & sq_mask;
+        sq_array[idx] = idx;
+
+        io_uring_sqe* sqe = (io_uring_sqe*)sqes + idx;
+        std::memset(sqe, 0, sizeof(*sqe));
+
+        ++sq_local_tail;
+        ++pending_sqes;
+        store_release(sq_tail, sq_local_tail);
+        return sqe;
+    }
+
+    bool submit() {
+        provide_run();
+        if (pending_sqes == 0)
+            return true;
+
+        int n = uring_enter(ring_fd, pending_sqes, 0, 0);
+        if (n < 0)
+            return errno == EINTR || errno == EAGAIN || errno == EBUSY;
+
+        pending_sqes -= unsigned(n);
+        return true;
+    }
+
+    // Submits whatever is queued and sleeps for `count` completions
+    bool wait(unsigned count) {
+        provide_run();
+        int n = uring_enter(ring_fd, pending_sqes, count,
+                            IORING_ENTER_GETEVENTS);
+        if (n < 0)
+            return errno == EINTR || errno == EAGAIN || errno == EBUSY;
+
+        pending_sqes -= unsigned(n);
+        return true;
+    }
+
+    // ---- completion ----
+    void reap() {
+        unsigned head = *cq_head;
+        const unsigned tail = load_acquire(cq_tail);
+
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes[head & cq_mask];
+
+            if (cqe.user_data == TAG_PROVIDE)
+                continue;
+
+            if (cqe.user_data != TAG_RECV) {
+                free_slots[free_slot_count++] = uint32_t(cqe.user_data);
+                --sends_in_flight;
+                continue;
+            }
+
+            if (!(cqe.flags & IORING_CQE_F_MORE))
+                recv_armed = false;
+
+            if (cqe.res < 0 || !(cqe.flags & IORING_CQE_F_BUFFER))
+                continue; // -ENOBUFS: every buffer is waiting to be read
+
+            const uint16_t b = uint16_t(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            const size_t   at = (ready_head + ready_count) % URING_RECV_BUFFERS;
+            ready[at] = Ready{ b, uint32_t(cqe.res) };
+            ++ready_count;
+        }
+
+        store_release(cq_head, head);
+    }
+
+    uint8_t* recv_buffer(uint16_t b) {
+        return (uint8_t*)recv_bytes_base + size_t(b) * URING_RECV_BYTES;
+    }
+
+    // Hands a read buffer back to the kernel. Neighbouring buffers
+    // are usually read in order, so they go back as one run.
+    void recycle(uint16_t b) {
+        if (run_count > 0 && b == run_start + run_count) {
+            ++run_count;
+            return;
+        }
+
+        provide_run();
+        run_start = b;
+        run_count = 1;
+    }
+
+    bool provide_run() {
+        if (run_count == 0)
+            return true;
+
+        const uint16_t start = run_start;
+        const uint32_t count = run_count;
+        run_count = 0; // next_sqe() may submit, which comes back here
+
+        io_uring_sqe* sqe = next_sqe();
+        if (!sqe) {
+            run_count = count;
+            return false;
+        }
+
+        sqe->opcode    = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd        = int32_t(count);
+        sqe->addr      = uint64_t(uintptr_t(recv_buffer(start)));
+        sqe->len       = uint32_t(URING_RECV_BYTES);
+        sqe->off       = start;
+        sqe->buf_group = URING_BUFFER_GROUP;
+        sqe->user_data = TAG_PROVIDE;
+        return true;
+    }
+
+    int sockfd  = -1;
+    int ring_fd = -1;
+
+    // ---- rings (shared with the kernel) ----
+    void*         sq_ring = MAP_FAILED;
+    void*         cq_ring = MAP_FAILED;
+    void*         sqes    = MAP_FAILED;
+    size_t        sq_ring_bytes = 0;
+    size_t        cq_ring_bytes = 0;
+    unsigned*     sq_head  = nullptr;
+    unsigned*     sq_tail  = nullptr;
+    unsigned*     sq_array = nullptr;
+    unsigned      sq_mask  = 0;
+    unsigned      sq_entries = 0;
+    unsigned      sq_local_tail = 0;
+    unsigned      pending_sqes  = 0; // queued, not yet submitted
+    unsigned*     cq_head = nullptr;
+    unsigned*     cq_tail = nullptr;
+    unsigned      cq_mask = 0;
+    io_uring_cqe* cqes    = nullptr;
+
+    // ---- receive ----
+    void*    recv_bytes_base = MAP_FAILED;
+    uint16_t run_start = 0; // buffers read but not yet handed back
+    uint32_t run_count = 0;
+    msghdr   recv_msg{};
+    bool     recv_armed = false;
+
+    Ready  ready[URING_RECV_BUFFERS]; // completions not yet returned
+    size_t ready_head  = 0;
+    size_t ready_count = 0;
+
+    // ---- send ----
+    SendSlot slots[URING_SEND_SLOTS];
+    uint32_t free_slots[URING_SEND_SLOTS];
+    uint32_t free_slot_count = 0;
+    uint32_t sends_in_flight = 0;
+
+    sockaddr_in last_peer{};
+    bool has_peer = false;
+};
+
+UdpSocket* create_udp_uring(uint16_t port) {
+    UdpSocketUring* s = new UdpSocketUring();
+    if (!s->open(port)) {
+        delete s;
+        return nullptr;
+    }
+    return s;
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include <cstdint>
+
+#include "sentinel/net/transport/udp_socket.hpp"
+
+// io_uring backend for UdpSocket::create(); nullptr if the kernel
+// refuses the ring or the socket cannot be bound
+UdpSocket* create_udp_uring(uint16_t port);
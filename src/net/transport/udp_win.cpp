@@ -70,6 +70,7 @@ public:
     }
 };
 
-UdpSocket* UdpSocket::create(const char*, uint16_t port) {
+// Only the syscall backend exists here
+UdpSocket* UdpSocket::create(const char*, uint16_t port, UdpBackend) {
     return new UdpSocketWin(port);
 }
@@ -0,0 +1,169 @@
+#include "capture.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static size_t padded(size_t n) {
+    return (n + 7) & ~size_t(7);
+}
+
+// ------------------------------------------------------------
+// Writer
+// ------------------------------------------------------------
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+bool CaptureWriter::open(const std::string& path, uint64_t start) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror("capture open");
+        return false;
+    }
+
+    start_ns = start;
+    if (!grow(sizeof(CaptureFileHeader)))
+        return false;
+
+    CaptureFileHeader hdr{};
+    std::memcpy(hdr.magic, CAPTURE_MAGIC, sizeof(hdr.magic));
+    hdr.version  = CAPTURE_VERSION;
+    hdr.start_ns = start_ns;
+
+    std::memcpy(map, &hdr, sizeof(hdr));
+    used = sizeof(hdr);
+    return true;
+}
+
+bool CaptureWriter::grow(size_t need) {
+    if (used + need <= mapped)
+        return true;
+
+    size_t size = mapped + CAPTURE_CHUNK;
+    while (size < used + need)
+        size += CAPTURE_CHUNK;
+
+    if (ftruncate(fd, off_t(size)) < 0) {
+        perror("capture grow");
+        return false;
+    }
+
+    void* p = map
+        ? mremap(map, mapped, size, MREMAP_MAYMOVE)
+        : mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (p == MAP_FAILED) {
+        perror("capture map");
+        return false;
+    }
+
+    map    = (uint8_t*)p;
+    mapped = size;
+    return true;
+}
+
+void CaptureWriter::append(uint64_t now_ns, uint64_t addr_key,
+                           const uint8_t* data, size_t size) {
+    if (!map || size == 0)
+        return;
+
+    const size_t total = sizeof(CaptureRecord) + padded(size);
+    if (!grow(total))
+        return;
+
+    CaptureRecord rec{};
+    rec.t_ns     = now_ns - start_ns;
+    rec.addr_key = addr_key;
+    rec.size     = uint32_t(size);
+
+    std::memcpy(map + used, &rec, sizeof(rec));
+    std::memcpy(map + used + sizeof(rec), data, size);
+
+    used    += total;
+    records += 1;
+}
+
+void CaptureWriter::close() {
+    if (map) {
+        munmap(map, mapped);
+        map = nullptr;
+    }
+
+    if (fd >= 0) {
+        if (ftruncate(fd, off_t(used)) < 0)
+            perror("capture trim");
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+// ------------------------------------------------------------
+// Reader
+// ------------------------------------------------------------
+CaptureReader::~CaptureReader() {
+    if (map)
+        munmap((void*)map, mapped);
+    if (fd >= 0)
+        close(fd);
+}
+
+bool CaptureReader::open(const std::string& path) {
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("capture open");
+        return false;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) < 0 || size_t(st.st_size) < sizeof(CaptureFileHeader)) {
+        fprintf(stderr, "[capture] %s: too short\n", path.c_str());
+        return false;
+    }
+
+    mapped = size_t(st.st_size);
+    void* p = mmap(nullptr, mapped, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        perror("capture map");
+        return false;
+    }
+    map = (const uint8_t*)p;
+
+    CaptureFileHeader hdr{};
+    std::memcpy(&hdr, map, sizeof(hdr));
+    if (std::memcmp(hdr.magic, CAPTURE_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != CAPTURE_VERSION) {
+        fprintf(stderr, "[capture] %s: not a capture file\n", path.c_str());
+        return false;
+    }
+
+    // Replay walks the file front to back once per pass
+    madvise((void*)map, mapped, MADV_SEQUENTIAL);
+
+    rewind();
+    return true;
+}
+
+bool CaptureReader::next(Entry& out) {
+    if (offset + sizeof(CaptureRecord) > mapped)
+        return false;
+
+    CaptureRecord rec{};
+    std::memcpy(&rec, map + offset, sizeof(rec));
+
+    if (rec.size == 0 ||
+        offset + sizeof(rec) + padded(rec.size) > mapped)
+        return false; // unused tail, or cut short
+
+    out.t_ns     = rec.t_ns;
+    out.addr_key = rec.addr_key;
+    out.data     = map + offset + sizeof(rec);
+    out.size     = rec.size;
+
+    offset += sizeof(rec) + padded(rec.size);
+    return true;
+}
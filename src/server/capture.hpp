@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ------------------------------------------------------------
+// Ingress capture file
+// ------------------------------------------------------------
+// Append-only: a CaptureFileHeader, then one CaptureRecord per
+// datagram followed by its payload, padded to 8 bytes. The file is
+// grown in chunks and written through a shared mapping, so a killed
+// server still leaves every appended record on disk; the unused tail
+// of the last chunk reads as a zero-size record, which ends the file.
+constexpr char     CAPTURE_MAGIC[8] = { 'S','N','T','L','C','A','P','1' };
+constexpr uint32_t CAPTURE_VERSION  = 1;
+constexpr size_t   CAPTURE_CHUNK    = size_t(64) << 20;
+
+struct CaptureFileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t start_ns;  // CLOCK_MONOTONIC at open
+};
+
+struct CaptureRecord {
+    uint64_t t_ns;      // since start_ns
+    uint64_t addr_key;  // see addr_key()
+    uint32_t size;      // payload bytes, never 0
+    uint32_t reserved;
+};
+
+static_assert(sizeof(CaptureFileHeader) % 8 == 0, "records stay aligned");
+static_assert(sizeof(CaptureRecord) % 8 == 0, "records stay aligned");
+
+class CaptureWriter {
+public:
+    ~CaptureWriter();
+
+    bool open(const std::string& path, uint64_t start_ns);
+
+    // now_ns is CLOCK_MONOTONIC; empty datagrams are skipped
+    void append(uint64_t now_ns, uint64_t addr_key,
+                const uint8_t* data, size_t size);
+
+    // Trims the file to what was written
+    void close();
+
+    uint64_t records = 0;
+
+private:
+    bool grow(size_t need);
+
+    int      fd = -1;
+    uint8_t* map = nullptr;
+    size_t   mapped = 0;
+    size_t   used = 0;
+    uint64_t start_ns = 0;
+};
+
+class CaptureReader {
+public:
+    struct Entry {
+        uint64_t       t_ns;
+        uint64_t       addr_key;
+        const uint8_t* data;
+        size_t         size;
+    };
+
+    ~CaptureReader();
+
+    bool open(const std::string& path);
+
+    // False at the end of the capture
+    bool next(Entry& out);
+    void rewind() { offset = sizeof(CaptureFileHeader); }
+
+private:
+    int            fd = -1;
+    const uint8_t* map = nullptr;
+    size_t         mapped = 0;
+    size_t         offset = 0;
+};
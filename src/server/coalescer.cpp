@@ -0,0 +1,34 @@
+#include "coalescer.hpp"
+
+#include <cstring>
+
+bool PacketCoalescer::add(const void* data, size_t size) {
+    const size_t need = BUNDLE_RECORD_BYTES + size;
+    if (sizeof(BundleHeader) + need > BUNDLE_MTU)
+        return false;
+
+    // First datagram with room; a client's tick rarely opens more than
+    // a few, so the scan is short
+    size_t i = 0;
+    while (i < used && datagrams[i].size + need > BUNDLE_MTU)
+        ++i;
+
+    if (i == used) {
+        if (used == COALESCE_MAX_DATAGRAMS)
+            return false;
+
+        Datagram& d = datagrams[used++];
+        BundleHeader hdr{};
+        std::memcpy(d.bytes, &hdr, sizeof(hdr));
+        d.size  = sizeof(hdr);
+        d.count = 0;
+    }
+
+    Datagram& d = datagrams[i];
+    const uint16_t len = uint16_t(size);
+    std::memcpy(d.bytes + d.size, &len, sizeof(len));
+    std::memcpy(d.bytes + d.size + BUNDLE_RECORD_BYTES, data, size);
+    d.size  += need;
+    d.count += 1;
+    return true;
+}
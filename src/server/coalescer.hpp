@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "sentinel/net/protocol/bundle.hpp"
+
+// ------------------------------------------------------------
+// Per-client coalescing
+// ------------------------------------------------------------
+// Collects everything one client gets in a tick and packs it first-fit
+// into as few BUNDLE datagrams as fit BUNDLE_MTU. A datagram that ends
+// up with a single packet goes out as that packet alone, so the bundle
+// header is only paid when it saves a datagram.
+//
+// Packets are copied in; flush() hands each datagram to the caller and
+// starts over for the next client.
+
+constexpr size_t COALESCE_MAX_DATAGRAMS = 80; // per client per tick
+
+class PacketCoalescer {
+public:
+    // Copies one complete packet in. False if it cannot share a
+    // datagram (too large) or every datagram is used; the caller then
+    // sends it on its own.
+    bool add(const void* data, size_t size);
+
+    // Calls send(data, size) per datagram, then empties the builder
+    template <class Send>
+    void flush(Send&& send) {
+        for (size_t i = 0; i < used; ++i) {
+            Datagram& d = datagrams[i];
+
+            if (d.count == 1) {
+                const size_t skip = sizeof(BundleHeader) + BUNDLE_RECORD_BYTES;
+                send(d.bytes + skip, d.size - skip);
+            } else {
+                send(d.bytes, d.size);
+            }
+        }
+        used = 0;
+    }
+
+    size_t pending() const { return used; }
+
+private:
+    struct Datagram {
+        size_t  size  = 0;
+        size_t  count = 0;
+        uint8_t bytes[BUNDLE_MTU];
+    };
+
+    Datagram datagrams[COALESCE_MAX_DATAGRAMS];
+    size_t   used = 0;
+};
@@ -0,0 +1,96 @@
+#include "input_buffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr uint32_t INPUT_MASK = INPUT_BUFFER_SIZE - 1;
+
+static_assert((INPUT_BUFFER_SIZE & INPUT_MASK) == 0,
+              "input buffer size must be a power of two");
+
+// Command ticks wrap; compare them as a signed distance
+static bool before(uint32_t a, uint32_t b) {
+    return int32_t(a - b) < 0;
+}
+
+static float axis(float v) {
+    return std::isfinite(v) ? std::clamp(v, -1.0f, 1.0f) : 0.0f;
+}
+
+bool InputBuffer::push(const InputCmd& cmd, InputStats& stats) {
+    if (cmd.tick == 0)
+        return false;
+
+    // Already played, or too far behind to have a slot
+    if ((playing && before(cmd.tick, next)) ||
+        (newest != 0 && before(cmd.tick, newest - INPUT_BUFFER_SIZE + 1))) {
+        ++stats.late;
+        return false;
+    }
+
+    const uint32_t slot = cmd.tick & INPUT_MASK;
+    if (ticks[slot] == cmd.tick)
+        return false; // duplicate
+
+    ticks[slot] = cmd.tick;
+    inputs[slot].throttle = axis(cmd.throttle);
+    inputs[slot].strafe   = axis(cmd.strafe);
+    inputs[slot].vertical = axis(cmd.vertical);
+    inputs[slot].yaw      = axis(cmd.yaw);
+    inputs[slot].pitch    = axis(cmd.pitch);
+    inputs[slot].boost    = (cmd.buttons & INPUT_BUTTON_BOOST) != 0;
+
+    // Until playback starts, the earliest command received goes first
+    if (next == 0 || (!playing && before(cmd.tick, next)))
+        next = cmd.tick;
+
+    if (newest == 0 || before(newest, cmd.tick))
+        newest = cmd.tick;
+
+    return true;
+}
+
+SimInput InputBuffer::pop(uint32_t delay, InputStats& stats) {
+    if (next == 0)
+        return last; // nothing received yet
+
+    int32_t backlog = int32_t(newest - next) + 1;
+
+    if (!playing) {
+        if (backlog < int32_t(delay))
+            return last;
+        playing = true;
+    }
+
+    // Trim back to delay + 1 queued; stale slots are told apart by tick
+    if (backlog > int32_t(2 * delay + 1)) {
+        const uint32_t target = newest - delay;
+        stats.skipped += target - next;
+        next    = target;
+        backlog = int32_t(delay) + 1;
+    }
+
+    if (backlog <= 0)
+        return miss(stats); // starved: hold place for the late command
+
+    const uint32_t slot = next++ & INPUT_MASK;
+    if (ticks[slot] != next - 1)
+        return miss(stats); // lost; later commands are already here
+
+    last        = inputs[slot];
+    ticks[slot] = 0;
+    misses      = 0;
+    applied     = next - 1;
+    return last;
+}
+
+SimInput InputBuffer::miss(InputStats& stats) {
+    if (misses == INPUT_REPEAT_MAX) {
+        last = SimInput{}; // a silent client is idle, not missing
+        return last;
+    }
+
+    ++misses;
+    ++stats.missing;
+    return last;
+}
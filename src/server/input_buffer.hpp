@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+
+#include "sentinel/net/protocol/snapshot.hpp"
+#include "sentinel/sim/sim_update.hpp"
+
+// ------------------------------------------------------------
+// Input buffer
+// ------------------------------------------------------------
+// One client's InputCmds, keyed by the client's command tick. The
+// simulation takes exactly one input per server tick.
+//
+// Playback starts once `delay` commands are queued, so that much
+// arrival jitter is absorbed. A lost command repeats the previous
+// input; an empty buffer also repeats it but holds its place, letting
+// the window stretch instead of discarding the late command. After
+// INPUT_REPEAT_MAX misses in a row the input falls back to neutral,
+// so a silent client stops instead of flying on. A backlog past twice
+// the delay is skipped so latency stays bounded.
+
+constexpr uint32_t INPUT_BUFFER_SIZE = 16; // power of two
+constexpr uint32_t INPUT_DELAY_MAX   = (INPUT_BUFFER_SIZE - 2) / 2;
+constexpr uint32_t INPUT_REPEAT_MAX  = 8;  // ticks
+
+struct InputStats {
+    uint64_t late    = 0; // arrived after its tick was played
+    uint64_t missing = 0; // ticks that repeated the previous input
+    uint64_t skipped = 0; // commands dropped to trim a backlog
+};
+
+class InputBuffer {
+public:
+    // Stores a command; false if it is stale, a duplicate or invalid.
+    // Axes are clamped to [-1, 1].
+    bool push(const InputCmd& cmd, InputStats& stats);
+
+    // Input for the next simulation tick
+    SimInput pop(uint32_t delay, InputStats& stats);
+
+    // Newest command played so far, 0 = none; repeats do not count
+    uint32_t applied_tick() const { return applied; }
+
+private:
+    SimInput miss(InputStats& stats);
+
+    SimInput inputs[INPUT_BUFFER_SIZE];
+    uint32_t ticks[INPUT_BUFFER_SIZE] = {}; // 0 = empty
+
+    SimInput last;            // repeated on a miss
+    uint32_t misses  = 0;     // in a row
+    uint32_t next    = 0;     // command tick played next; 0 = none yet
+    uint32_t newest  = 0;
+    uint32_t applied = 0;
+    bool     playing = false; // initial delay filled
+};
@@ -0,0 +1,17 @@
+#include "interest_grid.hpp"
+
+void InterestGrid::clear() {
+    // Drop cells that stayed empty for a whole tick, keep the rest
+    for (auto it = cells.begin(); it != cells.end();) {
+        if (it->second.empty()) {
+            it = cells.erase(it);
+        } else {
+            it->second.clear();
+            ++it;
+        }
+    }
+}
+
+void InterestGrid::insert(uint32_t id, float x, float z) {
+    cells[key(cell_coord(x), cell_coord(z))].push_back({ id, x, z });
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// ------------------------------------------------------------
+// Uniform spatial grid on the XZ plane
+// ------------------------------------------------------------
+// Rebuilt from scratch every tick. Cell vectors keep their capacity
+// across rebuilds, so steady state does not allocate.
+class InterestGrid {
+public:
+    struct Entry {
+        uint32_t id;
+        float    x, z;
+    };
+
+    explicit InterestGrid(float cell_size) : cell(cell_size) {}
+
+    void clear();
+    void insert(uint32_t id, float x, float z);
+
+    // Calls visit(entry) for every entry within `radius` of (x, z)
+    template <class F>
+    void query(float x, float z, float radius, F&& visit) const {
+        const int32_t cx0 = cell_coord(x - radius);
+        const int32_t cx1 = cell_coord(x + radius);
+        const int32_t cz0 = cell_coord(z - radius);
+        const int32_t cz1 = cell_coord(z + radius);
+        const float   r2  = radius * radius;
+
+        for (int32_t cz = cz0; cz <= cz1; ++cz) {
+            for (int32_t cx = cx0; cx <= cx1; ++cx) {
+                auto it = cells.find(key(cx, cz));
+                if (it == cells.end())
+                    continue;
+
+                for (const Entry& e : it->second) {
+                    float dx = e.x - x;
+                    float dz = e.z - z;
+                    if (dx * dx + dz * dz <= r2)
+                        visit(e);
+                }
+            }
+        }
+    }
+
+private:
+    int32_t cell_coord(float v) const {
+        return int32_t(std::floor(v / cell));
+    }
+
+    static uint64_t key(int32_t cx, int32_t cz) {
+        return (uint64_t(uint32_t(cx)) << 32) | uint32_t(cz);
+    }
+
+    float cell;
+    std::unordered_map<uint64_t, std::vector<Entry>> cells;
+};
@@ -0,0 +1,63 @@
+#include "lag_history.hpp"
+
+static constexpr uint32_t LAG_HISTORY_MASK = LAG_HISTORY_TICKS - 1;
+
+static_assert((LAG_HISTORY_TICKS & LAG_HISTORY_MASK) == 0,
+              "lag history length must be a power of two");
+
+int32_t LagHistory::Frame::find(uint32_t id) const {
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (ids[mid] < id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo < count && ids[lo] == id ? int32_t(lo) : -1;
+}
+
+void LagHistory::record(uint32_t tick, const EntityState* entities,
+                        size_t count) {
+    Slot& s = slots[tick & LAG_HISTORY_MASK];
+    s.tick = tick;
+
+    s.ids.resize(count);
+    s.x.resize(count);
+    s.y.resize(count);
+    s.z.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        s.ids[i] = entities[i].player_id;
+        s.x[i]   = entities[i].x;
+        s.y[i]   = entities[i].y;
+        s.z[i]   = entities[i].z;
+    }
+
+    newest = tick;
+}
+
+bool LagHistory::rewind(uint32_t tick, Frame& out) const {
+    if (newest == 0)
+        return false;
+
+    if (int32_t(tick - newest) > 0)
+        tick = newest;
+    else if (newest - tick >= LAG_HISTORY_TICKS)
+        tick = newest - LAG_HISTORY_TICKS + 1;
+
+    // Ticks run without a world update (timer overruns) were never
+    // recorded; take the next one that was
+    while (slots[tick & LAG_HISTORY_MASK].tick != tick)
+        ++tick;
+
+    const Slot& s = slots[tick & LAG_HISTORY_MASK];
+    out.tick  = s.tick;
+    out.count = s.ids.size();
+    out.ids   = s.ids.data();
+    out.x     = s.x.data();
+    out.y     = s.y.data();
+    out.z     = s.z.data();
+    return true;
+}
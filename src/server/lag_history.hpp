@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "sentinel/net/protocol/snapshot.hpp"
+
+// ------------------------------------------------------------
+// Lag compensation history
+// ------------------------------------------------------------
+// Where every player was on each of the last LAG_HISTORY_TICKS ticks,
+// so hit tests can run against the world a shooter actually saw.
+//
+// Frames sit in a ring indexed by tick, so rewinding is O(1). Each
+// frame is SoA: ids sorted ascending, then x, y and z. A radius test
+// is one pass over three float arrays. That is 16 bytes per player
+// per tick, just under 1 KB per player-second at 60 Hz. Frame storage
+// only grows to the largest world seen and is reused after that.
+
+constexpr uint32_t LAG_HISTORY_TICKS = 64; // power of two, >= 1 s at 60 Hz
+
+class LagHistory {
+public:
+    // One recorded tick
+    struct Frame {
+        uint32_t        tick  = 0;
+        size_t          count = 0;
+        const uint32_t* ids = nullptr;
+        const float*    x = nullptr;
+        const float*    y = nullptr;
+        const float*    z = nullptr;
+
+        // Index of a player, or -1
+        int32_t find(uint32_t id) const;
+
+        // Calls fn(index, distance squared) for every player within r
+        template <class Fn>
+        void within(float px, float py, float pz, float r, Fn&& fn) const {
+            const float r2 = r * r;
+            for (size_t i = 0; i < count; ++i) {
+                float dx = x[i] - px, dy = y[i] - py, dz = z[i] - pz;
+                float d2 = dx * dx + dy * dy + dz * dz;
+                if (d2 <= r2)
+                    fn(i, d2);
+            }
+        }
+    };
+
+    // The world after `tick`; entities sorted by player_id
+    void record(uint32_t tick, const EntityState* entities, size_t count);
+
+    // Frame for `tick`, clamped into the kept window. False if nothing
+    // has been recorded yet.
+    bool rewind(uint32_t tick, Frame& out) const;
+
+private:
+    struct Slot {
+        uint32_t              tick = 0; // 0 = never written
+        std::vector<uint32_t> ids;
+        std::vector<float>    x, y, z;
+    };
+
+    Slot     slots[LAG_HISTORY_TICKS];
+    uint32_t newest = 0;
+};
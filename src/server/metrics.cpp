@@ -0,0 +1,278 @@
+#include "metrics.hpp"
+
+#include <cstdarg>
+#include <cstdio>
+
+const char* packet_kind_name(PacketKind kind) {
+    switch (kind) {
+    case PacketKind::HELLO:           return "hello";
+    case PacketKind::CHAT:            return "chat";
+    case PacketKind::SNAPSHOT:        return "snapshot";
+    case PacketKind::SNAPSHOT_ACK:    return "snapshot_ack";
+    case PacketKind::WORLD_SNAPSHOT:  return "world_snapshot";
+    case PacketKind::INPUT:           return "input";
+    case PacketKind::PLAYER_STATE:    return "player_state";
+    case PacketKind::RELIABLE:        return "reliable";
+    case PacketKind::MISSILE_FIRE:    return "missile_fire";
+    case PacketKind::MISSILE_EXPLODE: return "missile_explode";
+    default:                          return "unknown";
+    }
+}
+
+// ------------------------------------------------------------
+// Histogram
+// ------------------------------------------------------------
+size_t histogram_bucket(uint64_t v) {
+    if (v < HIST_SUB)
+        return size_t(v);
+
+    // Top SUB_BITS + 1 significant bits pick the bucket
+    uint32_t msb = 63u - uint32_t(__builtin_clzll(v));
+    uint32_t shift = msb - HIST_SUB_BITS;
+    return size_t(shift + 1) * HIST_SUB + size_t((v >> shift) - HIST_SUB);
+}
+
+uint64_t histogram_bucket_high(size_t b) {
+    if (b < HIST_SUB)
+        return b;
+
+    uint32_t shift = uint32_t(b / HIST_SUB) - 1;
+    uint64_t sub = b % HIST_SUB;
+    return ((HIST_SUB + sub + 1) << shift) - 1;
+}
+
+uint64_t HistogramCounts::percentile(double q) const {
+    if (total == 0)
+        return 0;
+
+    uint64_t rank = uint64_t(q * double(total) + 0.5);
+    if (rank < 1)
+        rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t b = 0; b < HIST_BUCKETS; ++b) {
+        seen += counts[b];
+        if (seen >= rank) {
+            uint64_t high = histogram_bucket_high(b);
+            return high < max ? high : max;
+        }
+    }
+
+    return max;
+}
+
+void LatencyHistogram::add_to(HistogramCounts& out) const {
+    for (size_t b = 0; b < HIST_BUCKETS; ++b)
+        out.counts[b] += counts[b].load(std::memory_order_relaxed);
+
+    out.total += total.load(std::memory_order_relaxed);
+    out.sum   += sum.load(std::memory_order_relaxed);
+
+    uint64_t m = max.load(std::memory_order_relaxed);
+    if (m > out.max)
+        out.max = m;
+}
+
+// ------------------------------------------------------------
+// Collect / format
+// ------------------------------------------------------------
+void collect_metrics(const std::vector<const WorkerMetrics*>& workers,
+                     MetricsSnapshot& out) {
+    out = MetricsSnapshot{};
+
+    for (const WorkerMetrics* w : workers) {
+        for (size_t k = 0; k < PACKET_KINDS; ++k) {
+            out.packets_in[k]  += w->packets_in[k].get();
+            out.packets_out[k] += w->packets_out[k].get();
+        }
+
+        out.bytes_in    += w->bytes_in.get();
+        out.bytes_out   += w->bytes_out.get();
+        out.datagrams_out += w->datagrams_out.get();
+        out.send_errors += w->send_errors.get();
+        out.evictions   += w->evictions.get();
+        out.input_late    += w->input_late.get();
+        out.input_missing += w->input_missing.get();
+        out.input_skipped += w->input_skipped.get();
+        out.hit_checks    += w->hit_checks.get();
+        out.hits          += w->hits.get();
+        out.hits_rejected += w->hits_rejected.get();
+        out.missiles_fired   += w->missiles_fired.get();
+        out.missiles_dropped += w->missiles_dropped.get();
+        out.missile_hits     += w->missile_hits.get();
+        out.missiles         += w->missiles.get();
+        out.reliable_resent  += w->reliable_resent.get();
+        out.reliable_dropped += w->reliable_dropped.get();
+        out.packet_buffers           += w->packet_buffers.get();
+        out.packet_buffers_allocated += w->packet_buffers_allocated.get();
+        out.packet_buffers_exhausted += w->packet_buffers_exhausted.get();
+        out.recv_dropped             += w->recv_dropped.get();
+        out.sessions    += w->sessions.get();
+
+        w->tick_ns.add_to(out.tick_ns);
+    }
+}
+
+__attribute__((format(printf, 2, 3)))
+static void append(std::string& out, const char* fmt, ...) {
+    char line[256];
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+
+    if (n > 0)
+        out.append(line, size_t(n) < sizeof(line) ? size_t(n) : sizeof(line) - 1);
+}
+
+static void header(std::string& out, const char* name, const char* type,
+                   const char* help) {
+    append(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+void format_prometheus(const MetricsSnapshot& m, std::string& out) {
+    out.clear();
+
+    header(out, "sentinel_packets_received_total", "counter",
+        "Datagrams received, by packet type.");
+    for (size_t k = 0; k < PACKET_KINDS; ++k)
+        append(out, "sentinel_packets_received_total{type=\"%s\"} %llu\n",
+            packet_kind_name(PacketKind(k)),
+            (unsigned long long)m.packets_in[k]);
+
+    header(out, "sentinel_packets_sent_total", "counter",
+        "Packets queued for sending, by packet type.");
+    for (size_t k = 0; k < PACKET_KINDS; ++k)
+        append(out, "sentinel_packets_sent_total{type=\"%s\"} %llu\n",
+            packet_kind_name(PacketKind(k)),
+            (unsigned long long)m.packets_out[k]);
+
+    header(out, "sentinel_datagrams_sent_total", "counter",
+        "Datagrams queued for sending, with packets coalesced.");
+    append(out, "sentinel_datagrams_sent_total %llu\n",
+        (unsigned long long)m.datagrams_out);
+
+    header(out, "sentinel_received_bytes_total", "counter",
+        "UDP payload bytes received.");
+    append(out, "sentinel_received_bytes_total %llu\n",
+        (unsigned long long)m.bytes_in);
+
+    header(out, "sentinel_sent_bytes_total", "counter",
+        "UDP payload bytes queued for sending.");
+    append(out, "sentinel_sent_bytes_total %llu\n",
+        (unsigned long long)m.bytes_out);
+
+    header(out, "sentinel_send_errors_total", "counter",
+        "Datagrams dropped by a failed sendmmsg.");
+    append(out, "sentinel_send_errors_total %llu\n",
+        (unsigned long long)m.send_errors);
+
+    header(out, "sentinel_sessions_evicted_total", "counter",
+        "Sessions closed for being idle.");
+    append(out, "sentinel_sessions_evicted_total %llu\n",
+        (unsigned long long)m.evictions);
+
+    header(out, "sentinel_input_late_total", "counter",
+        "Input commands that arrived after their tick was simulated.");
+    append(out, "sentinel_input_late_total %llu\n",
+        (unsigned long long)m.input_late);
+
+    header(out, "sentinel_input_missing_total", "counter",
+        "Player ticks simulated with repeated input.");
+    append(out, "sentinel_input_missing_total %llu\n",
+        (unsigned long long)m.input_missing);
+
+    header(out, "sentinel_input_skipped_total", "counter",
+        "Input commands dropped to trim a client's backlog.");
+    append(out, "sentinel_input_skipped_total %llu\n",
+        (unsigned long long)m.input_skipped);
+
+    header(out, "sentinel_hit_checks_total", "counter",
+        "Missile explosions tested against the rewound world.");
+    append(out, "sentinel_hit_checks_total %llu\n",
+        (unsigned long long)m.hit_checks);
+
+    header(out, "sentinel_hits_total", "counter",
+        "Rewound explosions that caught a player.");
+    append(out, "sentinel_hits_total %llu\n",
+        (unsigned long long)m.hits);
+
+    header(out, "sentinel_hits_rejected_total", "counter",
+        "Explosions dropped as out of the shooter's reach.");
+    append(out, "sentinel_hits_rejected_total %llu\n",
+        (unsigned long long)m.hits_rejected);
+
+    header(out, "sentinel_missiles_fired_total", "counter",
+        "Missiles launched on the server.");
+    append(out, "sentinel_missiles_fired_total %llu\n",
+        (unsigned long long)m.missiles_fired);
+
+    header(out, "sentinel_missiles_dropped_total", "counter",
+        "Launches refused: duplicate id or no room.");
+    append(out, "sentinel_missiles_dropped_total %llu\n",
+        (unsigned long long)m.missiles_dropped);
+
+    header(out, "sentinel_missile_hits_total", "counter",
+        "Missiles that flew into a player.");
+    append(out, "sentinel_missile_hits_total %llu\n",
+        (unsigned long long)m.missile_hits);
+
+    header(out, "sentinel_missiles_active", "gauge",
+        "Missiles in flight across all workers.");
+    append(out, "sentinel_missiles_active %llu\n",
+        (unsigned long long)m.missiles);
+
+    header(out, "sentinel_reliable_resent_total", "counter",
+        "Reliable messages sent again after a timeout.");
+    append(out, "sentinel_reliable_resent_total %llu\n",
+        (unsigned long long)m.reliable_resent);
+
+    header(out, "sentinel_reliable_dropped_total", "counter",
+        "Reliable messages refused because a client's window was full.");
+    append(out, "sentinel_reliable_dropped_total %llu\n",
+        (unsigned long long)m.reliable_dropped);
+
+    header(out, "sentinel_packet_buffers_in_use", "gauge",
+        "Pooled packet buffers held by a view, all workers.");
+    append(out, "sentinel_packet_buffers_in_use %llu\n",
+        (unsigned long long)m.packet_buffers);
+
+    header(out, "sentinel_packet_buffers_allocated", "gauge",
+        "Pooled packet buffers allocated, all workers.");
+    append(out, "sentinel_packet_buffers_allocated %llu\n",
+        (unsigned long long)m.packet_buffers_allocated);
+
+    header(out, "sentinel_packet_buffers_exhausted_total", "counter",
+        "Packet buffer requests refused with a pool at its cap.");
+    append(out, "sentinel_packet_buffers_exhausted_total %llu\n",
+        (unsigned long long)m.packet_buffers_exhausted);
+
+    header(out, "sentinel_recv_dropped_total", "counter",
+        "Datagrams read and dropped with no packet buffer free.");
+    append(out, "sentinel_recv_dropped_total %llu\n",
+        (unsigned long long)m.recv_dropped);
+
+    header(out, "sentinel_sessions_active", "gauge",
+        "Connected sessions across all workers.");
+    append(out, "sentinel_sessions_active %llu\n",
+        (unsigned long long)m.sessions);
+
+    const HistogramCounts& h = m.tick_ns;
+
+    header(out, "sentinel_tick_duration_seconds", "summary",
+        "Time spent per server tick, all workers.");
+    const double quantiles[] = { 0.5, 0.99, 0.999 };
+    for (double q : quantiles)
+        append(out, "sentinel_tick_duration_seconds{quantile=\"%g\"} %.9f\n",
+            q, double(h.percentile(q)) * 1e-9);
+    append(out, "sentinel_tick_duration_seconds_sum %.9f\n",
+        double(h.sum) * 1e-9);
+    append(out, "sentinel_tick_duration_seconds_count %llu\n",
+        (unsigned long long)h.total);
+
+    header(out, "sentinel_tick_duration_max_seconds", "gauge",
+        "Longest server tick since start.");
+    append(out, "sentinel_tick_duration_max_seconds %.9f\n",
+        double(h.max) * 1e-9);
+}
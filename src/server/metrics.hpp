@@ -0,0 +1,173 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------
+// Metrics
+// ------------------------------------------------------------
+// Every worker owns one WorkerMetrics and is its only writer, so an
+// update is a relaxed load + store on a cache line no other thread
+// writes: no locked instructions, a few ns per event. Readers merge
+// all workers on demand; each value is untorn but the set as a whole
+// is not a consistent cut, which is fine for monitoring.
+
+class Counter {
+public:
+    void add(uint64_t n = 1) {
+        value.store(value.load(std::memory_order_relaxed) + n,
+                    std::memory_order_relaxed);
+    }
+
+    void set(uint64_t v) { value.store(v, std::memory_order_relaxed); }
+
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{ 0 };
+};
+
+// Labels for per-type packet counters
+enum class PacketKind : uint8_t {
+    HELLO,
+    CHAT,
+    SNAPSHOT,
+    SNAPSHOT_ACK,
+    WORLD_SNAPSHOT,
+    INPUT,
+    PLAYER_STATE,
+    RELIABLE,
+    MISSILE_FIRE,
+    MISSILE_EXPLODE,
+    UNKNOWN,
+
+    COUNT
+};
+
+constexpr size_t PACKET_KINDS = size_t(PacketKind::COUNT);
+
+const char* packet_kind_name(PacketKind kind);
+
+// ------------------------------------------------------------
+// Latency histogram
+// ------------------------------------------------------------
+// HDR-style log-linear buckets: values below 2^SUB_BITS get their own
+// bucket, every power of two above is split into 2^SUB_BITS linear
+// sub-buckets. Relative error stays under 1/32 from 1 ns to ~18 min.
+constexpr uint32_t HIST_SUB_BITS  = 5;
+constexpr uint32_t HIST_SUB       = 1u << HIST_SUB_BITS;
+constexpr uint32_t HIST_MAX_BITS  = 40; // values clamp to 2^40 - 1
+constexpr size_t   HIST_BUCKETS   =
+    size_t(HIST_MAX_BITS - HIST_SUB_BITS + 1) * HIST_SUB;
+
+size_t   histogram_bucket(uint64_t value);
+uint64_t histogram_bucket_high(size_t bucket); // largest value in it
+
+// Plain, mergeable copy of a histogram
+struct HistogramCounts {
+    uint64_t counts[HIST_BUCKETS] = {};
+    uint64_t total = 0;
+    uint64_t sum   = 0;
+    uint64_t max   = 0;
+
+    // Smallest bucket bound covering fraction q of samples
+    uint64_t percentile(double q) const;
+};
+
+class LatencyHistogram {
+public:
+    void record(uint64_t value) {
+        if (value >= (uint64_t(1) << HIST_MAX_BITS))
+            value = (uint64_t(1) << HIST_MAX_BITS) - 1;
+
+        bump(counts[histogram_bucket(value)], 1);
+        bump(total, 1);
+        bump(sum, value);
+
+        if (value > max.load(std::memory_order_relaxed))
+            max.store(value, std::memory_order_relaxed);
+    }
+
+    void add_to(HistogramCounts& out) const;
+
+private:
+    static void bump(std::atomic<uint64_t>& c, uint64_t n) {
+        c.store(c.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> counts[HIST_BUCKETS] = {};
+    std::atomic<uint64_t> total{ 0 };
+    std::atomic<uint64_t> sum{ 0 };
+    std::atomic<uint64_t> max{ 0 };
+};
+
+// ------------------------------------------------------------
+// Per-worker set
+// ------------------------------------------------------------
+struct alignas(64) WorkerMetrics {
+    Counter packets_in[PACKET_KINDS];
+    Counter packets_out[PACKET_KINDS];
+    Counter bytes_in;
+    Counter bytes_out;
+    Counter datagrams_out; // after coalescing; packets_out counts packets
+    Counter send_errors;
+    Counter evictions;
+    Counter input_late;    // InputCmds that missed their tick
+    Counter input_missing; // player ticks that repeated old input
+    Counter input_skipped; // InputCmds dropped to trim a backlog
+    Counter hit_checks;    // rewound explosion tests
+    Counter hits;          // ... that caught a player
+    Counter hits_rejected; // ... out of the shooter's reach
+    Counter missiles_fired;
+    Counter missiles_dropped; // duplicate id or table full
+    Counter missile_hits;     // server-side swept hits
+    Counter missiles;         // gauge, in flight
+    Counter reliable_resent;  // messages sent again after a timeout
+    Counter reliable_dropped; // messages refused, client's window full
+    Counter packet_buffers;           // gauge, pooled buffers in use
+    Counter packet_buffers_allocated; // gauge, carved from slabs so far
+    Counter packet_buffers_exhausted; // acquires refused at the cap
+    Counter recv_dropped;             // datagrams read with no buffer free
+    Counter sessions;   // gauge
+
+    LatencyHistogram tick_ns; // expire + simulate + world build + fan-out
+};
+
+// Sum of every worker at one point in time
+struct MetricsSnapshot {
+    uint64_t packets_in[PACKET_KINDS]  = {};
+    uint64_t packets_out[PACKET_KINDS] = {};
+    uint64_t bytes_in    = 0;
+    uint64_t bytes_out   = 0;
+    uint64_t datagrams_out = 0;
+    uint64_t send_errors = 0;
+    uint64_t evictions   = 0;
+    uint64_t input_late    = 0;
+    uint64_t input_missing = 0;
+    uint64_t input_skipped = 0;
+    uint64_t hit_checks    = 0;
+    uint64_t hits          = 0;
+    uint64_t hits_rejected = 0;
+    uint64_t missiles_fired   = 0;
+    uint64_t missiles_dropped = 0;
+    uint64_t missile_hits     = 0;
+    uint64_t missiles         = 0;
+    uint64_t reliable_resent  = 0;
+    uint64_t reliable_dropped = 0;
+    uint64_t packet_buffers           = 0;
+    uint64_t packet_buffers_allocated = 0;
+    uint64_t packet_buffers_exhausted = 0;
+    uint64_t recv_dropped             = 0;
+    uint64_t sessions    = 0;
+
+    HistogramCounts tick_ns;
+};
+
+void collect_metrics(const std::vector<const WorkerMetrics*>& workers,
+                     MetricsSnapshot& out);
+
+// Prometheus text exposition format (version 0.0.4)
+void format_prometheus(const MetricsSnapshot& m, std::string& out);
@@ -0,0 +1,136 @@
+#include "metrics_server.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+MetricsServer::MetricsServer(std::vector<const WorkerMetrics*> w)
+    : workers(std::move(w)) {}
+
+MetricsServer::~MetricsServer() {
+    if (listenfd >= 0) {
+        close(listenfd);
+        unlink(socket_path.c_str());
+    }
+}
+
+bool MetricsServer::open(const std::string& sock, const std::string& file,
+                         int interval) {
+    socket_path   = sock;
+    file_path     = file;
+    file_interval = interval > 0 ? interval : 10;
+
+    if (socket_path.empty())
+        return true;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "[metrics] socket path too long\n");
+        return false;
+    }
+    std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    listenfd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenfd < 0) {
+        perror("metrics socket");
+        return false;
+    }
+
+    // A previous run may have left the socket file behind
+    unlink(socket_path.c_str());
+
+    if (bind(listenfd, (sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(listenfd, 8) < 0) {
+        perror("metrics bind");
+        close(listenfd);
+        listenfd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+void MetricsServer::render() {
+    collect_metrics(workers, snapshot);
+    format_prometheus(snapshot, text);
+}
+
+void MetricsServer::serve_one() {
+    int fd = accept4(listenfd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    render();
+
+    size_t off = 0;
+    while (off < text.size()) {
+        // A scraper hanging up mid-dump must not SIGPIPE the server
+        ssize_t n = send(fd, text.data() + off, text.size() - off,
+                         MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        off += size_t(n);
+    }
+
+    close(fd);
+}
+
+void MetricsServer::write_file() {
+    render();
+
+    // Write aside and rename so a scraper never sees half a file
+    std::string tmp = file_path + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (!f) {
+        perror("metrics file");
+        return;
+    }
+
+    bool ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+    ok = fclose(f) == 0 && ok;
+
+    if (ok)
+        rename(tmp.c_str(), file_path.c_str());
+}
+
+void MetricsServer::run() {
+    if (listenfd < 0 && file_path.empty())
+        return;
+
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    time_t next_file = now.tv_sec + file_interval;
+
+    while (true) {
+        int timeout = -1;
+        if (!file_path.empty()) {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            timeout = now.tv_sec >= next_file
+                ? 0 : int(next_file - now.tv_sec) * 1000;
+        }
+
+        pollfd p{ listenfd, POLLIN, 0 };
+        int n = poll(&p, listenfd >= 0 ? 1 : 0, timeout);
+
+        if (n > 0 && (p.revents & POLLIN))
+            serve_one();
+
+        if (!file_path.empty()) {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (now.tv_sec >= next_file) {
+                write_file();
+                next_file = now.tv_sec + file_interval;
+            }
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "metrics.hpp"
+
+// ------------------------------------------------------------
+// MetricsServer
+// ------------------------------------------------------------
+// Runs on its own thread, off the tick path. Each connection to the
+// UNIX socket gets one Prometheus text dump and is closed
+// (`socat - UNIX-CONNECT:<path>`). The same text can be rewritten to a
+// file at an interval for a node_exporter textfile collector.
+class MetricsServer {
+public:
+    explicit MetricsServer(std::vector<const WorkerMetrics*> workers);
+    ~MetricsServer();
+
+    // Either path may be empty. Returns false if the socket cannot be
+    // bound.
+    bool open(const std::string& socket_path, const std::string& file_path,
+              int file_interval);
+
+    void run();
+
+private:
+    void serve_one();
+    void write_file();
+    void render();
+
+    std::vector<const WorkerMetrics*> workers;
+
+    std::string socket_path;
+    std::string file_path;
+    int         file_interval = 10; // seconds
+
+    int listenfd = -1;
+
+    MetricsSnapshot snapshot;
+    std::string     text;
+};
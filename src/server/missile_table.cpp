@@ -0,0 +1,175 @@
+#include "missile_table.hpp"
+
+#include "sentinel/sim/missile.hpp"
+
+// ------------------------------------------------------------
+// HitGrid
+// ------------------------------------------------------------
+void HitGrid::build(const EntityState* players, size_t count) {
+    // About two buckets per player keeps chains short
+    uint32_t n = 64;
+    while (n < count * 2)
+        n <<= 1;
+    mask = n - 1;
+
+    starts.assign(n + 1, 0);
+    buckets.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        buckets[i] = bucket(cell_coord(players[i].x),
+                            cell_coord(players[i].z));
+        ++starts[buckets[i] + 1];
+    }
+
+    for (uint32_t b = 0; b < n; ++b)
+        starts[b + 1] += starts[b];
+
+    ids.resize(count);
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+
+    // Fill each bucket from its start; starts[] ends up shifted by one
+    // bucket, which the back-fill below undoes
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t k = starts[buckets[i]]++;
+        ids[k] = players[i].player_id;
+        x[k]   = players[i].x;
+        y[k]   = players[i].y;
+        z[k]   = players[i].z;
+    }
+
+    for (uint32_t b = n; b > 0; --b)
+        starts[b] = starts[b - 1];
+    starts[0] = 0;
+}
+
+// ------------------------------------------------------------
+// MissileTable
+// ------------------------------------------------------------
+bool MissileTable::spawn(uint32_t owner_id, uint32_t missile_id,
+                         float px, float py, float pz,
+                         float pvx, float pvy, float pvz) {
+    if (owners.size() >= MISSILE_CAPACITY)
+        return false;
+
+    if (!index.emplace(key(owner_id, missile_id), uint32_t(owners.size()))
+             .second)
+        return false;
+
+    owners.push_back(owner_id);
+    ids.push_back(missile_id);
+    x.push_back(px);
+    y.push_back(py);
+    z.push_back(pz);
+    vx.push_back(pvx);
+    vy.push_back(pvy);
+    vz.push_back(pvz);
+    life.push_back(MISSILE_LIFE);
+    return true;
+}
+
+bool MissileTable::detonate(uint32_t owner_id, uint32_t missile_id) {
+    auto it = index.find(key(owner_id, missile_id));
+    if (it == index.end())
+        return false;
+
+    remove(it->second);
+    return true;
+}
+
+void MissileTable::remove(size_t i) {
+    index.erase(key(owners[i], ids[i]));
+
+    const size_t last = owners.size() - 1;
+    if (i != last) {
+        owners[i] = owners[last];
+        ids[i]    = ids[last];
+        x[i]  = x[last];  y[i]  = y[last];  z[i]  = z[last];
+        vx[i] = vx[last]; vy[i] = vy[last]; vz[i] = vz[last];
+        life[i] = life[last];
+
+        index[key(owners[i], ids[i])] = uint32_t(i);
+    }
+
+    owners.pop_back();
+    ids.pop_back();
+    x.pop_back();  y.pop_back();  z.pop_back();
+    vx.pop_back(); vy.pop_back(); vz.pop_back();
+    life.pop_back();
+}
+
+void MissileTable::step(float dt, const HitGrid& grid,
+                        std::vector<MissileImpact>& impacts) {
+    const float r  = MISSILE_HIT_RADIUS;
+    const float r2 = r * r;
+
+    // A removed slot takes the last missile, which has not been stepped
+    // yet, so `i` only advances past survivors
+    size_t i = 0;
+    while (i < owners.size()) {
+        const float x0 = x[i], y0 = y[i], z0 = z[i];
+        const float dx = vx[i] * dt, dy = vy[i] * dt, dz = vz[i] * dt;
+        const float a  = dx * dx + dy * dy + dz * dz;
+
+        // Earliest time along this tick's segment that a drone's sphere
+        // is touched, in [0, 1]
+        float    best   = 2.0f;
+        uint32_t target = 0;
+
+        grid.query(std::fmin(x0, x0 + dx) - r, std::fmin(z0, z0 + dz) - r,
+                   std::fmax(x0, x0 + dx) + r, std::fmax(z0, z0 + dz) + r,
+            [&](uint32_t k) {
+                if (grid.ids[k] == owners[i])
+                    return;
+
+                const float mx = x0 - grid.x[k];
+                const float my = y0 - grid.y[k];
+                const float mz = z0 - grid.z[k];
+                const float c  = mx * mx + my * my + mz * mz - r2;
+
+                float t;
+                if (c <= 0.0f) {
+                    t = 0.0f;
+                } else {
+                    const float b = mx * dx + my * dy + mz * dz;
+                    if (b >= 0.0f || a == 0.0f)
+                        return; // moving away
+
+                    const float disc = b * b - a * c;
+                    if (disc < 0.0f)
+                        return;
+
+                    t = (-b - std::sqrt(disc)) / a;
+                    if (t > 1.0f)
+                        return;
+                }
+
+                if (t < best) {
+                    best   = t;
+                    target = grid.ids[k];
+                }
+            });
+
+        if (target != 0) {
+            impacts.push_back({ owners[i], ids[i], target,
+                                x0 + dx * best, y0 + dy * best,
+                                z0 + dz * best });
+            remove(i);
+            continue;
+        }
+
+        x[i] = x0 + dx;
+        y[i] = y0 + dy;
+        z[i] = z0 + dz;
+
+        life[i] -= dt;
+        if (life[i] <= 0.0f) {
+            impacts.push_back({ owners[i], ids[i], 0, x[i], y[i], z[i] });
+            remove(i);
+            continue;
+        }
+
+        ++i;
+    }
+}
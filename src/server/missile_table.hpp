@@ -0,0 +1,114 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "sentinel/net/protocol/snapshot.hpp"
+
+// ------------------------------------------------------------
+// Hit grid
+// ------------------------------------------------------------
+// Broadphase for projectile hits: players hashed by XZ cell into a
+// power-of-two bucket table, rebuilt each tick with one counting sort.
+// Buckets are flat ranges of one array, so a query walks contiguous
+// memory. Cells that collide in the hash only add candidates, the
+// narrowphase sorts them out.
+
+constexpr float HIT_CELL_SIZE = 4.0f; // metres
+
+class HitGrid {
+public:
+    void build(const EntityState* players, size_t count);
+
+    size_t size() const { return ids.size(); }
+
+    // Calls visit(index) for every player whose cell overlaps the XZ
+    // box; a player can come up more than once
+    template <class F>
+    void query(float x0, float z0, float x1, float z1, F&& visit) const {
+        if (ids.empty())
+            return;
+
+        const int32_t cx0 = cell_coord(x0), cx1 = cell_coord(x1);
+        const int32_t cz0 = cell_coord(z0), cz1 = cell_coord(z1);
+
+        for (int32_t cz = cz0; cz <= cz1; ++cz) {
+            for (int32_t cx = cx0; cx <= cx1; ++cx) {
+                const uint32_t b = bucket(cx, cz);
+                for (uint32_t k = starts[b]; k < starts[b + 1]; ++k)
+                    visit(k);
+            }
+        }
+    }
+
+    // Sorted by bucket; index with the values query() passes
+    std::vector<uint32_t> ids;
+    std::vector<float>    x, y, z;
+
+private:
+    static int32_t cell_coord(float v) {
+        return int32_t(std::floor(v * (1.0f / HIT_CELL_SIZE)));
+    }
+
+    uint32_t bucket(int32_t cx, int32_t cz) const {
+        uint32_t h = uint32_t(cx) * 0x9E3779B1u ^ uint32_t(cz) * 0x85EBCA77u;
+        return (h ^ (h >> 15)) & mask;
+    }
+
+    uint32_t              mask = 0;
+    std::vector<uint32_t> starts;  // bucket -> first index, plus an end
+    std::vector<uint32_t> buckets; // per input player
+};
+
+// ------------------------------------------------------------
+// Missile table
+// ------------------------------------------------------------
+// Every live projectile a worker owns, as dense SoA arrays with
+// swap-remove like the session table. A step moves each missile along
+// its path for one tick and tests the swept segment against the
+// players the hit grid returns near it, so the cost follows the
+// missile count and local density, not missiles x players.
+
+constexpr size_t MISSILE_CAPACITY   = 16384; // live missiles per worker
+constexpr float  MISSILE_HIT_RADIUS = 1.2f;  // missile + drone, metres
+
+struct MissileImpact {
+    uint32_t owner_id;
+    uint32_t missile_id;
+    uint32_t target_id; // 0 = expired without hitting anyone
+    float    x, y, z;
+};
+
+class MissileTable {
+public:
+    // False if full or (owner, missile_id) is already flying
+    bool spawn(uint32_t owner_id, uint32_t missile_id,
+               float x, float y, float z, float vx, float vy, float vz);
+
+    // Removes a missile; false if it is not in flight
+    bool detonate(uint32_t owner_id, uint32_t missile_id);
+
+    // Advances every missile by dt. Hits and expiries are removed and
+    // appended to `impacts`.
+    void step(float dt, const HitGrid& grid,
+              std::vector<MissileImpact>& impacts);
+
+    size_t size() const { return owners.size(); }
+
+private:
+    static uint64_t key(uint32_t owner_id, uint32_t missile_id) {
+        return (uint64_t(owner_id) << 32) | missile_id;
+    }
+
+    void remove(size_t i);
+
+    std::vector<uint32_t> owners;
+    std::vector<uint32_t> ids;
+    std::vector<float>    x, y, z;
+    std::vector<float>    vx, vy, vz;
+    std::vector<float>    life; // seconds left
+
+    std::unordered_map<uint64_t, uint32_t> index; // key -> dense slot
+};
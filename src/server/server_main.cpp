@@ -1,240 +1,111 @@
 #include <cstdio>
-#include <unordered_map>
-#include <arpa/inet.h>
-#include <unistd.h>
-#include <ctime>
+#include <cstdlib>
 #include <cstring>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
 
-#include "sentinel/net/protocol/snapshot.hpp"
-#include "sentinel/net/net_api.hpp"   // PacketHeader / PacketType
-#include "sentinel/net/protocol/chat.hpp"
+#include "metrics_server.hpp"
+#include "server_worker.hpp"
 
 // ------------------------------------------------------------
-// State
+// Main
 // ------------------------------------------------------------
-static int sockfd = -1;
-static uint32_t next_player_id = 1;
-
-static std::unordered_map<uint32_t, std::string> player_names;
-
-// addr_key -> player_id
-static std::unordered_map<uint64_t, uint32_t> addr_to_id;
+int main(int argc, char** argv) {
+    ServerConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--gso") == 0)
+            config.gso = true;
+        else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+            config.tick_rate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+            config.workers = size_t(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--idle-timeout") == 0 && i + 1 < argc)
+            config.idle_timeout = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--client-budget") == 0 && i + 1 < argc)
+            config.client_budget = size_t(atol(argv[++i]));
+        else if (strcmp(argv[i], "--input-delay") == 0 && i + 1 < argc)
+            config.input_delay = uint32_t(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+            config.capture_path = argv[++i];
+        else if (strcmp(argv[i], "--metrics-socket") == 0 && i + 1 < argc)
+            config.metrics_socket = argv[++i];
+        else if (strcmp(argv[i], "--metrics-file") == 0 && i + 1 < argc)
+            config.metrics_file = argv[++i];
+        else if (strcmp(argv[i], "--metrics-interval") == 0 && i + 1 < argc)
+            config.metrics_interval = atoi(argv[++i]);
+    }
 
-// player_id -> address
-static std::unordered_map<uint32_t, sockaddr_in> id_to_addr;
+    if (config.tick_rate != 20 && config.tick_rate != 30 &&
+        config.tick_rate != 60) {
+        fprintf(stderr, "[server] --tick-rate must be 20, 30 or 60\n");
+        return 1;
+    }
 
-// player_id -> last snapshot
-static std::unordered_map<uint32_t, Snapshot> players;
+    if (config.workers < 1 || config.workers > 64) {
+        fprintf(stderr, "[server] --workers must be between 1 and 64\n");
+        return 1;
+    }
 
-// ------------------------------------------------------------
-// Helpers
-// ------------------------------------------------------------
-static uint64_t addr_key(const sockaddr_in& a) {
-    return (uint64_t(a.sin_addr.s_addr) << 16) | ntohs(a.sin_port);
-}
+    if (config.idle_timeout < 1) {
+        fprintf(stderr, "[server] --idle-timeout must be at least 1 second\n");
+        return 1;
+    }
 
-static double server_time() {
-    timespec ts{};
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec * 1e-9;
-}
+    if (config.client_budget < WORLD_SNAPSHOT_MTU) {
+        fprintf(stderr, "[server] --client-budget must be at least %zu bytes\n",
+            WORLD_SNAPSHOT_MTU);
+        return 1;
+    }
 
-// ------------------------------------------------------------
-// Main
-// ------------------------------------------------------------
-int main() {
-    sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sockfd < 0) {
-        perror("socket");
+    if (config.input_delay > INPUT_DELAY_MAX) {
+        fprintf(stderr, "[server] --input-delay must be at most %u ticks\n",
+            INPUT_DELAY_MAX);
         return 1;
     }
 
-    sockaddr_in server{};
-    server.sin_family = AF_INET;
-    server.sin_addr.s_addr = INADDR_ANY;
-    server.sin_port = htons(7777);
+    ServerShared shared(config);
+    clock_gettime(CLOCK_MONOTONIC, &shared.epoch);
 
-    if (bind(sockfd, (sockaddr*)&server, sizeof(server)) < 0) {
-        perror("bind");
-        return 1;
+    std::vector<std::unique_ptr<ServerWorker>> workers;
+    for (size_t i = 0; i < config.workers; ++i) {
+        workers.push_back(std::make_unique<ServerWorker>(shared, i));
+        shared.workers.push_back(workers.back().get());
     }
 
-    printf("[server] listening on 0.0.0.0:7777\n");
-
-    while (true) {
-        uint8_t buffer[1024];
-        sockaddr_in from{};
-        socklen_t from_len = sizeof(from);
-
-        ssize_t n = recvfrom(
-            sockfd,
-            buffer,
-            sizeof(buffer),
-            0,
-            (sockaddr*)&from,
-            &from_len
-        );
-
-        if (n <= 0)
-            continue;
-
-        uint64_t key = addr_key(from);
-
-        // ----------------------------------------------------
-        // HELLO PACKET
-        // ----------------------------------------------------
-        if (n == sizeof(ChatMessage)) {
-            ChatMessage msg{};
-            memcpy(&msg, buffer, sizeof(msg));
-
-            if (!addr_to_id.count(key))
-                continue;
-
-            uint32_t pid = addr_to_id[key];
-            msg.player_id = pid;
-
-            if (!player_names.count(pid)) {
-                player_names[pid] = msg.name; // first name wins
-            }
-
-            strncpy(msg.name, player_names[pid].c_str(), MAX_NAME_LEN - 1);
-
-            for (const auto& [_, addr] : id_to_addr) {
-                sendto(sockfd, &msg, sizeof(msg), 0,
-                    (sockaddr*)&addr, sizeof(addr));
-            }
-
-            continue;
-        }
-
-
-        // ----------------------------------------------------
-        // SNAPSHOT PACKET
-        // ----------------------------------------------------
-        if (n == sizeof(Snapshot)) {
-            Snapshot incoming{};
-            std::memcpy(&incoming, buffer, sizeof(Snapshot));
-
-            if (!addr_to_id.count(key))
-                continue; // must HELLO first
-
-            uint32_t pid = addr_to_id[key];
-
-            incoming.player_id   = pid;
-            incoming.server_time = server_time();
-
-            players[pid] = incoming;
-            id_to_addr[pid] = from;
-
-            // Broadcast full world
-            for (const auto& [_, snap] : players) {
-                for (const auto& [__, addr] : id_to_addr) {
-                    sendto(
-                        sockfd,
-                        &snap,
-                        sizeof(snap),
-                        0,
-                        (sockaddr*)&addr,
-                        sizeof(addr)
-                    );
-                }
-            }
-
-            continue;
-        }
-        
-        // ----------------------------------------------------
-        // MISSILE FIRE EVENT
-        // ----------------------------------------------------
-        if (n == sizeof(MissileFireEvent)) {
-            MissileFireEvent ev{};
-            std::memcpy(&ev, buffer, sizeof(ev));
-
-            if (!addr_to_id.count(key))
-                continue;
-
-            uint32_t pid = addr_to_id[key];
-
-            // authoritative owner + time
-            ev.owner_id = pid;
-            ev.server_time = server_time();
-
-            for (const auto& [_, addr] : id_to_addr) {
-                sendto(
-                    sockfd,
-                    &ev,
-                    sizeof(ev),
-                    0,
-                    (sockaddr*)&addr,
-                    sizeof(addr)
-                );
-            }
-
-            continue;
-        }
-
-        // ----------------------------------------------------
-// MISSILE EXPLODE EVENT
-// ----------------------------------------------------
-        if (n == sizeof(MissileExplodeEvent)) {
-            MissileExplodeEvent ev{};
-            std::memcpy(&ev, buffer, sizeof(ev));
-
-            if (!addr_to_id.count(key))
-                continue;
-
-            uint32_t pid = addr_to_id[key];
-
-            // authoritative owner + time
-            ev.owner_id = pid;
-            ev.server_time = server_time();
-
-            for (const auto& [_, addr] : id_to_addr) {
-                sendto(
-                    sockfd,
-                    &ev,
-                    sizeof(ev),
-                    0,
-                    (sockaddr*)&addr,
-                    sizeof(addr)
-                );
-            }
-
-            continue;
-        }
-
-        // ----------------------------------------------------
-// CHAT MESSAGE
-// ----------------------------------------------------
-        if (n == sizeof(ChatMessage)) {
-            ChatMessage msg{};
-            std::memcpy(&msg, buffer, sizeof(msg));
-
-            if (!addr_to_id.count(key))
-                continue;
-
-            uint32_t pid = addr_to_id[key];
-            msg.player_id = pid;
-
-            // rebroadcast to ALL clients
-            for (const auto& [_, addr] : id_to_addr) {
-                sendto(
-                    sockfd,
-                    &msg,
-                    sizeof(msg),
-                    0,
-                    (sockaddr*)&addr,
-                    sizeof(addr)
-                );
-            }
-
-            continue;
-        }
-
-        // Unknown packet → ignore
+    for (auto& w : workers) {
+        if (!w->open())
+            return 1;
     }
 
-    close(sockfd);
+    std::vector<const WorkerMetrics*> worker_metrics;
+    for (auto& w : workers)
+        worker_metrics.push_back(&w->metrics);
+
+    MetricsServer metrics(worker_metrics);
+    if (!metrics.open(config.metrics_socket, config.metrics_file,
+                      config.metrics_interval))
+        return 1;
+
+    printf("[server] listening on 0.0.0.0:%u @ %d Hz, %zu worker(s)%s\n",
+        config.port, config.tick_rate, config.workers,
+        config.gso ? " (gso)" : "");
+
+    // Worker 0 runs on the main thread
+    std::vector<std::thread> threads;
+
+    if (!config.metrics_socket.empty() || !config.metrics_file.empty())
+        threads.emplace_back([&] { metrics.run(); });
+
+    for (size_t i = 1; i < workers.size(); ++i)
+        threads.emplace_back([&, i] { workers[i]->run(); });
+
+    workers[0]->run();
+
+    for (auto& t : threads)
+        t.join();
+
     return 0;
 }
-
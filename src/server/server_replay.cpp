@@ -0,0 +1,153 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+
+#include "capture.hpp"
+#include "server_worker.hpp"
+
+// ------------------------------------------------------------
+// Replay a capture through one server worker, without sockets
+// ------------------------------------------------------------
+//   server_replay <capture> [--speed N | --max] [--loops K]
+//                 [--tick-rate R] [--client-budget B]
+//
+// Ticks follow the capture's own clock, so every tick sees the same
+// datagrams it did live; --speed only changes how fast wall time
+// advances. --max never sleeps and measures raw throughput. Each of
+// the --loops starts from a fresh worker, so loops are comparable.
+
+static uint64_t monotonic_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+static void sleep_until(uint64_t target_ns) {
+    timespec ts{};
+    ts.tv_sec  = time_t(target_ns / 1000000000ull);
+    ts.tv_nsec = long(target_ns % 1000000000ull);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr,
+            "usage: %s <capture> [--speed N | --max] [--loops K] "
+            "[--tick-rate R] [--client-budget B]\n", argv[0]);
+        return 1;
+    }
+
+    std::string path = argv[1];
+    double speed = 1.0; // 0 = as fast as possible
+    int    loops = 1;
+
+    ServerConfig config;
+
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--max") == 0)
+            speed = 0.0;
+        else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+            speed = atof(argv[++i]);
+        else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc)
+            loops = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+            config.tick_rate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--client-budget") == 0 && i + 1 < argc)
+            config.client_budget = size_t(atol(argv[++i]));
+    }
+
+    if (config.tick_rate != 20 && config.tick_rate != 30 &&
+        config.tick_rate != 60) {
+        fprintf(stderr, "[replay] --tick-rate must be 20, 30 or 60\n");
+        return 1;
+    }
+
+    if (speed < 0.0 || loops < 1) {
+        fprintf(stderr, "[replay] bad --speed or --loops\n");
+        return 1;
+    }
+
+    CaptureReader capture;
+    if (!capture.open(path))
+        return 1;
+
+    const uint64_t tick_ns = 1000000000ull / uint64_t(config.tick_rate);
+
+    uint64_t datagrams = 0;
+    uint64_t ticks = 0;
+    uint64_t wall_start = monotonic_ns();
+
+    // Summed over loops; sessions is the last loop's
+    HistogramCounts tick_hist;
+    uint64_t bytes_out = 0;
+    uint64_t sessions  = 0;
+
+    for (int loop = 0; loop < loops; ++loop) {
+        capture.rewind();
+
+        // No sessions, baselines or timers carried over from the last
+        // loop; heap allocated, as a worker is several megabytes
+        auto shared = std::make_unique<ServerShared>(config);
+        clock_gettime(CLOCK_MONOTONIC, &shared->epoch);
+
+        auto worker = std::make_unique<ServerWorker>(*shared, 0);
+        shared->workers.push_back(worker.get());
+
+        uint64_t loop_start = monotonic_ns();
+        uint64_t next_tick = tick_ns;
+
+        CaptureReader::Entry e{};
+        while (capture.next(e)) {
+            while (e.t_ns >= next_tick) {
+                worker->tick();
+                next_tick += tick_ns;
+                ++ticks;
+            }
+
+            if (speed > 0.0)
+                sleep_until(loop_start + uint64_t(double(e.t_ns) / speed));
+
+            worker->ingest(e.data, e.size, addr_from_key(e.addr_key));
+            ++datagrams;
+        }
+
+        // Let the last datagrams reach a world update
+        worker->tick();
+        ++ticks;
+
+        MetricsSnapshot m;
+        collect_metrics({ &worker->metrics }, m);
+
+        for (size_t b = 0; b < HIST_BUCKETS; ++b)
+            tick_hist.counts[b] += m.tick_ns.counts[b];
+        tick_hist.total += m.tick_ns.total;
+        tick_hist.sum   += m.tick_ns.sum;
+        if (m.tick_ns.max > tick_hist.max)
+            tick_hist.max = m.tick_ns.max;
+
+        bytes_out += m.bytes_out;
+        sessions   = m.sessions;
+    }
+
+    double wall = double(monotonic_ns() - wall_start) * 1e-9;
+
+    printf("[replay] %llu datagrams, %llu ticks in %.3f s\n",
+        (unsigned long long)datagrams, (unsigned long long)ticks, wall);
+    printf("[replay] %.0f datagrams/s, %.0f ticks/s, %.1f ns per datagram\n",
+        double(datagrams) / wall, double(ticks) / wall,
+        wall * 1e9 / double(datagrams ? datagrams : 1));
+    printf("[replay] tick p50 %.1f us, p99 %.1f us, p999 %.1f us, "
+           "max %.1f us\n",
+        double(tick_hist.percentile(0.5)) * 1e-3,
+        double(tick_hist.percentile(0.99)) * 1e-3,
+        double(tick_hist.percentile(0.999)) * 1e-3,
+        double(tick_hist.max) * 1e-3);
+    printf("[replay] %llu bytes out, %llu sessions at end\n",
+        (unsigned long long)bytes_out,
+        (unsigned long long)sessions);
+
+    return 0;
+}
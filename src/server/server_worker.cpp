@@ -0,0 +1,1153 @@
+#include "server_worker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// AOI tuning
+static constexpr float AOI_CELL_SIZE    = 64.0f;
+static constexpr float AOI_ENTER_RADIUS = 200.0f;
+static constexpr float AOI_LEAVE_RADIUS = 240.0f; // hysteresis band
+static constexpr float EVENT_RADIUS     = AOI_LEAVE_RADIUS;
+
+// Send priority tuning (gain per tick)
+static constexpr float PRIORITY_SELF      = 1e9f;  // own entity always fits
+static constexpr float PRIORITY_ENTER     = 100.0f; // newly relevant
+static constexpr float PRIORITY_MIN_NEAR  = 0.1f;  // gain at the AOI edge
+static constexpr float PRIORITY_VEL_SCALE = 8.0f;  // velocity change per x1
+static constexpr float PRIORITY_VEL_MAX   = 4.0f;
+
+// Spawns follow a sunflower spiral: even spacing, no lookup
+static constexpr float SPAWN_SPACING = 20.0f; // metres
+static constexpr float SPAWN_HEIGHT  = 1.5f;
+static constexpr float GOLDEN_ANGLE  = 2.39996323f;
+
+// Missile launches: a client draws its drone ahead of the server's
+// body, so its muzzle is trusted only this close to it
+static constexpr float MISSILE_MUZZLE       = 1.4f; // ahead of the drone
+static constexpr float MISSILE_LAUNCH_SLACK = 6.0f; // metres
+
+// Packet pool: a buffer per datagram in flight through ingest, kept
+// past it only by events still waiting on some client's ack
+static constexpr size_t PACKET_POOL_SLAB = 256;   // buffers per slab
+static constexpr size_t PACKET_POOL_MAX  = 16384; // ~24 MB per worker
+
+static constexpr double STATS_INTERVAL = 5.0; // seconds
+
+// ------------------------------------------------------------
+// Helpers
+// ------------------------------------------------------------
+static double server_time() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t monotonic_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+static SimPlayer spawn_point(uint32_t slot) {
+    const float r = SPAWN_SPACING * std::sqrt(float(slot));
+    const float a = GOLDEN_ANGLE * float(slot);
+
+    SimPlayer p;
+    p.x   = r * std::cos(a);
+    p.y   = SPAWN_HEIGHT;
+    p.z   = r * std::sin(a);
+    p.yaw = a;
+    return p;
+}
+
+// Relayed events carry their own header
+static PacketKind event_kind(const void* data) {
+    PacketHeader hdr{};
+    std::memcpy(&hdr, data, sizeof(hdr));
+
+    switch (hdr.type) {
+    case PacketType::CHAT:            return PacketKind::CHAT;
+    case PacketType::MISSILE_FIRE:    return PacketKind::MISSILE_FIRE;
+    case PacketType::MISSILE_EXPLODE: return PacketKind::MISSILE_EXPLODE;
+    default:                          return PacketKind::UNKNOWN;
+    }
+}
+
+// ------------------------------------------------------------
+// Setup
+// ------------------------------------------------------------
+double ServerWorker::clock_now() const {
+    return shared.clock ? shared.clock() : server_time();
+}
+
+double ServerWorker::tick_time(uint32_t tick) const {
+    // The tick timer fires at epoch + tick * period
+    uint64_t period = 1000000000ull / uint64_t(shared.config.tick_rate);
+    return double(shared.epoch.tv_sec) + double(shared.epoch.tv_nsec) * 1e-9 +
+           double(uint64_t(tick) * period) * 1e-9;
+}
+
+ServerWorker::ServerWorker(ServerShared& s, size_t i)
+    : shared(s), index(i),
+      pool(RECV_PACKET_BYTES, PACKET_POOL_SLAB, PACKET_POOL_MAX),
+      rx(new RecvBatch(pool)), tx(new SendBatch()),
+      sessions(uint32_t(i)), views(SESSION_CAPACITY),
+      timers(SESSION_CAPACITY),
+      idle_ticks(uint32_t(s.config.idle_timeout * s.config.tick_rate)),
+      sim_dt(1.0f / float(s.config.tick_rate)),
+      interp_ticks(uint32_t(std::lround(INTERP_DELAY * s.config.tick_rate))),
+      grid(AOI_CELL_SIZE) {
+    char buf[32];
+    if (shared.config.workers > 1)
+        snprintf(buf, sizeof(buf), "[server:w%zu]", index);
+    else
+        snprintf(buf, sizeof(buf), "[server]");
+    tag = buf;
+}
+
+ServerWorker::~ServerWorker() {
+    if (epfd >= 0)    close(epfd);
+    if (eventfd >= 0) close(eventfd);
+    if (timerfd >= 0) close(timerfd);
+    if (sockfd >= 0)  close(sockfd);
+}
+
+bool ServerWorker::open() {
+    sockfd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (sockfd < 0) {
+        perror("socket");
+        return false;
+    }
+
+    // Every worker binds the same port; the kernel hashes each client
+    // 4-tuple onto one of them, so a session never changes worker.
+    int one = 1;
+    if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0) {
+        perror("SO_REUSEPORT");
+        return false;
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(shared.config.port);
+
+    if (bind(sockfd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        return false;
+    }
+
+    tx->attach(sockfd, shared.config.gso);
+
+    if (!shared.config.capture_path.empty()) {
+        std::string path = shared.config.capture_path;
+        if (shared.config.workers > 1)
+            path += ".w" + std::to_string(index);
+
+        capture.reset(new CaptureWriter());
+        if (!capture->open(path, monotonic_ns()))
+            return false;
+
+        printf("%s capturing ingress to %s\n", tag.c_str(), path.c_str());
+    }
+
+    // Absolute timer phase-locked to the shared epoch, so every worker
+    // agrees on the tick number
+    timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerfd < 0) {
+        perror("timerfd");
+        return false;
+    }
+
+    long period = 1000000000L / shared.config.tick_rate;
+
+    itimerspec its{};
+    its.it_interval.tv_nsec = period;
+    its.it_value = shared.epoch;
+    its.it_value.tv_nsec += period;
+    if (its.it_value.tv_nsec >= 1000000000L) {
+        its.it_value.tv_sec  += 1;
+        its.it_value.tv_nsec -= 1000000000L;
+    }
+
+    if (timerfd_settime(timerfd, TFD_TIMER_ABSTIME, &its, nullptr) < 0) {
+        perror("timerfd_settime");
+        return false;
+    }
+
+    eventfd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventfd < 0) {
+        perror("eventfd");
+        return false;
+    }
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        perror("epoll_create1");
+        return false;
+    }
+
+    for (int fd : { sockfd, timerfd, eventfd }) {
+        epoll_event ev{};
+        ev.events  = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    return true;
+}
+
+void ServerWorker::attach(UdpSocket& socket) {
+    io = &socket;
+    tx->attach(&socket);
+}
+
+void ServerWorker::poll() {
+    if (io)
+        drain_socket();
+    drain_inbox();
+}
+
+// ------------------------------------------------------------
+// Packet handler
+// ------------------------------------------------------------
+void ServerWorker::handle_packet(PacketRef& packet, const sockaddr_in& from) {
+    uint64_t key = addr_key(from);
+    PacketContext ctx{ from, key, sessions.find(key), &packet };
+
+    // Short, foreign-version, unknown-type and wrong-length packets
+    if (!Dispatch::dispatch(*this, packet.data(), packet.size(), ctx))
+        metrics.packets_in[size_t(PacketKind::UNKNOWN)].add();
+}
+
+bool ServerWorker::admit(const PacketContext& ctx, PacketKind kind) {
+    if (ctx.session == NO_SESSION) {
+        metrics.packets_in[size_t(PacketKind::UNKNOWN)].add();
+        return false; // must HELLO first
+    }
+
+    metrics.packets_in[size_t(kind)].add();
+    sessions.last_seen[ctx.session] = current_tick;
+    return true;
+}
+
+// ----------------------------------------------------
+// HELLO PACKET
+// ----------------------------------------------------
+void ServerWorker::on_packet(const Hello&, const PacketContext& ctx) {
+    metrics.packets_in[size_t(PacketKind::HELLO)].add();
+
+    int32_t s = ctx.session;
+    if (s == NO_SESSION) {
+        s = sessions.open(ctx.key, ctx.from);
+        if (s == NO_SESSION)
+            return; // full
+
+        const uint32_t slot = session_slot(sessions.ids[s]);
+        views[slot] = ClientView{};
+        sessions.idle_timer[s] =
+            timers.arm(current_tick + idle_ticks, sessions.ids[s]);
+
+        // In the world from now on, hovering until inputs arrive
+        const SimPlayer& body = sessions.bodies[s] = spawn_point(slot);
+        Snapshot& st = sessions.states[s];
+        st.player_id = sessions.ids[s];
+        st.tick = current_tick;
+        st.server_time = tick_time(current_tick);
+        st.x = body.x; st.y = body.y; st.z = body.z;
+        st.yaw = body.yaw; st.pitch = body.pitch;
+        sessions.has_state[s] = 1;
+    }
+
+    sessions.last_seen[s] = current_tick;
+
+    // The client adopts the id and spawn of the first Snapshot it
+    // receives; repeated HELLOs just get the current state back.
+    // server_time is on the tick timeline the client replicates on;
+    // sched_time is when the current tick was scheduled here.
+    Snapshot welcome = sessions.states[s];
+    welcome.tick        = current_tick;
+    welcome.server_time = double(current_tick) / shared.config.tick_rate;
+    welcome.sched_time  = tick_time(current_tick);
+    send_to(&welcome, sizeof(welcome), ctx.from, PacketKind::SNAPSHOT);
+}
+
+// ----------------------------------------------------
+// CHAT MESSAGE (first one registers the name)
+// ----------------------------------------------------
+void ServerWorker::on_packet(const ChatMessage& in, const PacketContext& ctx) {
+    if (!admit(ctx, PacketKind::CHAT))
+        return;
+
+    const int32_t s = ctx.session;
+
+    ChatMessage msg = in;
+    msg.player_id = sessions.ids[s];
+
+    // The wire name need not be terminated; both copies are bounded by
+    // the arrays and terminated here
+    char* name = sessions.names[s].text;
+    if (!name[0]) {
+        const size_t len = strnlen(msg.name, MAX_NAME_LEN - 1);
+        memcpy(name, msg.name, len); // first name wins
+        name[len] = '\0';
+    }
+
+    memcpy(msg.name, name, MAX_NAME_LEN);
+    msg.name[MAX_NAME_LEN - 1] = '\0';
+
+    // rebroadcast to ALL clients
+    relay_patched(ctx, msg, 0.0f, 0.0f, true);
+}
+
+// ----------------------------------------------------
+// INPUT COMMAND
+// ----------------------------------------------------
+void ServerWorker::on_packet(const InputCmd& cmd, const PacketContext& ctx) {
+    if (!admit(ctx, PacketKind::INPUT))
+        return;
+
+    // Buffered; simulate() plays one per tick
+    sessions.inputs[ctx.session].push(cmd, input_stats);
+
+    // Acks for our reliable packets ride on every command
+    sessions.reliable[ctx.session].on_ack(cmd.acks, clock_now());
+}
+
+// ----------------------------------------------------
+// SNAPSHOT ACK
+// ----------------------------------------------------
+void ServerWorker::on_packet(const SnapshotAck& ack, const PacketContext& ctx) {
+    if (!admit(ctx, PacketKind::SNAPSHOT_ACK))
+        return;
+
+    // Acks can arrive out of order; never step the baseline back
+    uint32_t& acked = sessions.acked_tick[ctx.session];
+    if (ack.tick <= acked || ack.tick > current_tick)
+        return;
+
+    // A fresh ack is the round trip of that world tick
+    float  sample = float(current_tick - ack.tick);
+    float& rtt    = sessions.rtt_ticks[ctx.session];
+    rtt = acked == 0 ? sample : rtt + (sample - rtt) * 0.125f;
+
+    acked = ack.tick;
+}
+
+// ----------------------------------------------------
+// RELIABLE (chat and missile events, in order)
+// ----------------------------------------------------
+void ServerWorker::on_packet(const ReliablePacket&, const uint8_t*,
+                             size_t, const PacketContext& ctx) {
+    if (!admit(ctx, PacketKind::RELIABLE))
+        return;
+
+    // Messages stay where they arrived, as views of the datagram
+    ReliableChannel& channel = sessions.reliable[ctx.session];
+    if (!channel.receive(*ctx.packet, clock_now()))
+        return;
+
+    // Each message is a whole packet and takes the normal handler
+    PacketRef msg;
+    while (channel.pop(msg)) {
+        PacketContext mctx{ ctx.from, ctx.key, ctx.session, &msg };
+        if (!ReliableDispatch::dispatch(*this, msg.data(), msg.size(), mctx))
+            metrics.packets_in[size_t(PacketKind::UNKNOWN)].add();
+    }
+}
+
+// ----------------------------------------------------
+// MISSILE FIRE EVENT
+// ----------------------------------------------------
+void ServerWorker::on_packet(const MissileFireEvent& in,
+                             const PacketContext& ctx) {
+    if (!admit(ctx, PacketKind::MISSILE_FIRE))
+        return;
+
+    MissileFireEvent ev = in;
+
+    // authoritative owner + time
+    ev.owner_id = sessions.ids[ctx.session];
+    ev.server_time = clock_now();
+
+    // Launch from the client's muzzle when it is plausible, else from
+    // the server's body; the speed is always the tuned one
+    const SimPlayer& body = sessions.bodies[ctx.session];
+    const float fx = std::cos(body.yaw), fz = std::sin(body.yaw);
+
+    float dx = ev.x - body.x, dy = ev.y - body.y, dz = ev.z - body.z;
+    if (!(dx * dx + dy * dy + dz * dz <=
+          MISSILE_LAUNCH_SLACK * MISSILE_LAUNCH_SLACK)) {
+        ev.x = body.x + fx * MISSILE_MUZZLE;
+        ev.y = body.y;
+        ev.z = body.z + fz * MISSILE_MUZZLE;
+    }
+
+    float len = std::sqrt(ev.vx * ev.vx + ev.vy * ev.vy + ev.vz * ev.vz);
+    if (!(len > 1e-3f) || !std::isfinite(len)) {
+        ev.vx = fx; ev.vy = 0.0f; ev.vz = fz;
+        len = 1.0f;
+    }
+
+    const float k = MISSILE_SPEED / len;
+    ev.vx *= k; ev.vy *= k; ev.vz *= k;
+
+    if (!missiles.spawn(ev.owner_id, ev.missile_id,
+                        ev.x, ev.y, ev.z, ev.vx, ev.vy, ev.vz)) {
+        metrics.missiles_dropped.add();
+        return;
+    }
+    metrics.missiles_fired.add();
+
+    // only players near the event hear about it
+    relay_patched(ctx, ev, ev.x, ev.z, false);
+}
+
+// ----------------------------------------------------
+// MISSILE EXPLODE EVENT
+// ----------------------------------------------------
+void ServerWorker::on_packet(const MissileExplodeEvent& in,
+                             const PacketContext& ctx) {
+    if (!admit(ctx, PacketKind::MISSILE_EXPLODE))
+        return;
+
+    MissileExplodeEvent ev = in;
+
+    // authoritative owner + time
+    ev.owner_id = sessions.ids[ctx.session];
+    ev.server_time = clock_now();
+    ev.target_id = 0;
+
+    if (!std::isfinite(ev.x) || !std::isfinite(ev.y) || !std::isfinite(ev.z))
+        return;
+
+    // Only a missile still in flight can be detonated; one that hit
+    // something or expired was already announced
+    if (!missiles.detonate(ev.owner_id, ev.missile_id))
+        return;
+
+    // Judge the blast against the world the shooter was looking at
+    uint32_t back = uint32_t(std::lround(sessions.rtt_ticks[ctx.session])) +
+                    interp_ticks;
+
+    LagHistory::Frame f;
+    if (history.rewind(current_tick - back, f)) {
+        metrics.hit_checks.add();
+
+        // Nothing the shooter fired could have flown farther than this
+        int32_t self = f.find(ev.owner_id);
+        if (self >= 0) {
+            float dx = ev.x - f.x[self];
+            float dy = ev.y - f.y[self];
+            float dz = ev.z - f.z[self];
+            float reach = MISSILE_SPEED * MISSILE_LIFE + EXPLOSION_MAX_RADIUS;
+
+            if (dx * dx + dy * dy + dz * dz > reach * reach) {
+                metrics.hits_rejected.add();
+                return;
+            }
+        }
+
+        float best = EXPLOSION_MAX_RADIUS * EXPLOSION_MAX_RADIUS;
+        f.within(ev.x, ev.y, ev.z, EXPLOSION_MAX_RADIUS,
+            [&](size_t i, float d2) {
+                if (f.ids[i] != ev.owner_id && d2 <= best) {
+                    best = d2;
+                    ev.target_id = f.ids[i];
+                }
+            });
+
+        if (ev.target_id != 0)
+            metrics.hits.add();
+    }
+
+    relay_patched(ctx, ev, ev.x, ev.z, false);
+}
+
+// ------------------------------------------------------------
+// Missiles
+// ------------------------------------------------------------
+// Runs after gather_world() so hits test against this tick's players,
+// and before the broadcast so impacts go out this tick. Every missed
+// tick moves the missiles too.
+void ServerWorker::step_missiles(uint32_t ticks) {
+    if (missiles.size() != 0) {
+        const WorldFrame& cur = world_history[current_tick % WORLD_HISTORY];
+        hit_grid.build(cur.entities.data(), cur.entities.size());
+
+        impact_scratch.clear();
+        for (uint32_t k = 0; k < ticks; ++k)
+            missiles.step(sim_dt, hit_grid, impact_scratch);
+
+        const double now = clock_now();
+
+        for (const MissileImpact& m : impact_scratch) {
+            MissileExplodeEvent ev{};
+            ev.owner_id    = m.owner_id;
+            ev.missile_id  = m.missile_id;
+            ev.x           = m.x;
+            ev.y           = m.y;
+            ev.z           = m.z;
+            ev.server_time = now;
+            ev.target_id   = m.target_id;
+
+            if (m.target_id != 0)
+                metrics.missile_hits.add();
+
+            relay_event(&ev, sizeof(ev), ev.x, ev.z, false);
+        }
+    }
+
+    metrics.missiles.set(missiles.size());
+}
+
+// ------------------------------------------------------------
+// Event fan-out
+// ------------------------------------------------------------
+// Events queue on each recipient's reliable channel; broadcast_world()
+// sends them with the tick. Every channel holds a view of the same
+// buffer, which goes back to the pool when the last client acks.
+void ServerWorker::send_local(const PacketRef& ev,
+                              float x, float z, bool global) {
+    const PacketKind kind = event_kind(ev.data());
+
+    auto queue = [&](int32_t s) {
+        if (sessions.reliable[s].send(ev, reliable_stats))
+            metrics.packets_out[size_t(kind)].add();
+    };
+
+    if (global) {
+        for (size_t i = 0; i < sessions.size(); ++i)
+            queue(int32_t(i));
+        return;
+    }
+
+    // Interest-managed: only this worker's clients near (x, z)
+    grid.query(x, z, EVENT_RADIUS, [&](const InterestGrid::Entry& e) {
+        int32_t s = sessions.find_id(e.id);
+        if (s != NO_SESSION)
+            queue(s);
+    });
+}
+
+void ServerWorker::relay_event(const void* data, size_t size,
+                               float x, float z, bool global) {
+    PacketRef ev = pool.copy(data, size);
+    if (ev)
+        relay_event(ev, x, z, global);
+}
+
+void ServerWorker::relay_event(const PacketRef& ev,
+                               float x, float z, bool global) {
+    send_local(ev, x, z, global);
+
+    // Other workers' pools are theirs alone; the inbox copies
+    for (ServerWorker* w : shared.workers) {
+        if (w != this)
+            w->post_event(ev.data(), ev.size(), x, z, global);
+    }
+}
+
+template <class T>
+void ServerWorker::relay_patched(const PacketContext& ctx, const T& p,
+                                 float x, float z, bool global) {
+    // Dispatch checked the length, so p fits the view exactly
+    ctx.packet->store(p);
+    relay_event(*ctx.packet, x, z, global);
+}
+
+void ServerWorker::post_event(const void* data, size_t size,
+                              float x, float z, bool global) {
+    if (size > RELAY_MAX_BYTES)
+        return;
+
+    RelayedEvent ev{};
+    std::memcpy(ev.bytes, data, size);
+    ev.size   = size;
+    ev.x      = x;
+    ev.z      = z;
+    ev.global = global;
+
+    {
+        std::lock_guard<std::mutex> lock(inbox_lock);
+        inbox.push_back(ev);
+    }
+
+    uint64_t one = 1;
+    (void)!write(eventfd, &one, sizeof(one));
+}
+
+void ServerWorker::drain_inbox() {
+    uint64_t count = 0;
+    (void)!read(eventfd, &count, sizeof(count));
+
+    {
+        std::lock_guard<std::mutex> lock(inbox_lock);
+        inbox_scratch.swap(inbox);
+    }
+
+    for (const RelayedEvent& ev : inbox_scratch) {
+        PacketRef copy = pool.copy(ev.bytes, ev.size);
+        if (copy)
+            send_local(copy, ev.x, ev.z, ev.global);
+    }
+
+    inbox_scratch.clear();
+    flush_sends();
+}
+
+void ServerWorker::send_to(const void* data, size_t size,
+                           const sockaddr_in& to, PacketKind kind) {
+    metrics.packets_out[size_t(kind)].add();
+    send_datagram(data, size, to);
+}
+
+void ServerWorker::send_datagram(const void* data, size_t size,
+                                 const sockaddr_in& to) {
+    tx->queue(data, size, to);
+
+    metrics.datagrams_out.add();
+    metrics.bytes_out.add(size);
+}
+
+void ServerWorker::coalesce(const void* data, size_t size,
+                            const sockaddr_in& to, PacketKind kind) {
+    metrics.packets_out[size_t(kind)].add();
+
+    if (!coalescer.add(data, size))
+        send_datagram(data, size, to);
+}
+
+void ServerWorker::flush_sends() {
+    tx->flush();
+
+    // tx->errors also counts flushes queue() made on its own
+    metrics.send_errors.add(tx->errors - errors_counted);
+    errors_counted = tx->errors;
+}
+
+void ServerWorker::drain_socket() {
+    while (true) {
+        const uint64_t dropped = rx->dropped;
+        int count = io ? rx->recv(*io) : rx->recv(sockfd);
+        metrics.recv_dropped.add(rx->dropped - dropped);
+        if (count <= 0)
+            break;
+
+        for (int i = 0; i < count; ++i) {
+            if (capture) {
+                capture->append(monotonic_ns(), addr_key(rx->from(i)),
+                                rx->data(i), rx->size(i));
+            }
+
+            ingest(rx->packet(i), rx->from(i));
+        }
+
+        if (count < RECV_BATCH_SIZE)
+            break; // socket is empty
+    }
+
+    // chat / missile relays go out right away, not on the tick
+    flush_sends();
+}
+
+// ------------------------------------------------------------
+// Simulation
+// ------------------------------------------------------------
+void ServerWorker::simulate() {
+    const size_t n = sessions.size();
+
+    // One buffered input per player, then one pass over every body
+    input_scratch.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        input_scratch[i] = sessions.inputs[i].pop(
+            shared.config.input_delay, input_stats);
+
+    sim_update_batch(sim_world, sessions.bodies.data(),
+                     input_scratch.data(), n, sim_dt);
+
+    const double t = tick_time(current_tick);
+
+    for (size_t i = 0; i < n; ++i) {
+        const SimPlayer& p = sessions.bodies[i];
+        Snapshot& st = sessions.states[i];
+
+        st.vx = (p.x - st.x) / sim_dt;
+        st.vy = (p.y - st.y) / sim_dt;
+        st.vz = (p.z - st.z) / sim_dt;
+
+        st.x = p.x; st.y = p.y; st.z = p.z;
+        st.yaw   = p.yaw;
+        st.pitch = p.pitch;
+
+        st.tick        = current_tick;
+        st.server_time = t;
+    }
+
+    metrics.input_late.add(input_stats.late);
+    metrics.input_missing.add(input_stats.missing);
+    metrics.input_skipped.add(input_stats.skipped);
+    input_stats = InputStats{};
+}
+
+// ------------------------------------------------------------
+// Tick
+// ------------------------------------------------------------
+const ServerWorker::WorldFrame*
+ServerWorker::baseline_frame(uint32_t tick) const {
+    if (tick == 0 || current_tick - tick >= WORLD_HISTORY)
+        return nullptr;
+
+    const WorldFrame& f = world_history[tick % WORLD_HISTORY];
+    return f.tick == tick ? &f : nullptr;
+}
+
+void ServerWorker::update_relevance(int32_t s, ClientView& v) {
+    if (!sessions.has_state[s]) {
+        v.relevant.clear(); // no position yet
+        v.tracks.clear();
+        return;
+    }
+
+    const uint32_t pid = sessions.ids[s];
+    const float enter2 = AOI_ENTER_RADIUS * AOI_ENTER_RADIUS;
+    const float x = sessions.states[s].x;
+    const float z = sessions.states[s].z;
+
+    relevant_scratch.clear();
+
+    grid.query(x, z, AOI_LEAVE_RADIUS, [&](const InterestGrid::Entry& e) {
+        float dx = e.x - x;
+        float dz = e.z - z;
+
+        // Enter inside the inner radius, leave beyond the outer one
+        if (e.id == pid || dx * dx + dz * dz <= enter2 ||
+            std::binary_search(v.relevant.begin(), v.relevant.end(), e.id))
+            relevant_scratch.push_back(e.id);
+    });
+
+    std::sort(relevant_scratch.begin(), relevant_scratch.end());
+
+    // Carry accumulated priority over for entities that stay relevant
+    tracks_scratch.clear();
+    size_t k = 0;
+    for (uint32_t id : relevant_scratch) {
+        while (k < v.relevant.size() && v.relevant[k] < id)
+            ++k;
+
+        if (k < v.relevant.size() && v.relevant[k] == id) {
+            tracks_scratch.push_back(v.tracks[k]);
+        } else {
+            Track t;
+            t.priority      = PRIORITY_ENTER;
+            t.waiting_since = current_tick;
+            tracks_scratch.push_back(t);
+        }
+    }
+
+    v.relevant.swap(relevant_scratch);
+    v.tracks.swap(tracks_scratch);
+}
+
+float ServerWorker::priority_gain(const EntityState& e, const Track& t,
+                                  float x, float z) const {
+    // Closer matters more: 1 at the viewer down to the floor at the edge
+    float dx = e.x - x;
+    float dz = e.z - z;
+    float near = 1.0f - std::sqrt(dx * dx + dz * dz) / AOI_LEAVE_RADIUS;
+    near = std::max(near, PRIORITY_MIN_NEAR);
+
+    // Velocity changes since the last send are what extrapolation
+    // gets wrong
+    float dvx = e.vx - t.vx;
+    float dvy = e.vy - t.vy;
+    float dvz = e.vz - t.vz;
+    float dv = std::sqrt(dvx * dvx + dvy * dvy + dvz * dvz);
+    float turn = std::min(dv / PRIORITY_VEL_SCALE, PRIORITY_VEL_MAX);
+
+    return near * (1.0f + turn);
+}
+
+// Publish our players, read everyone's back, and index this tick's
+// world for hit tests, event interest and the per-client builds
+void ServerWorker::gather_world() {
+    own_scratch.clear();
+    for (size_t i = 0; i < sessions.size(); ++i) {
+        if (sessions.has_state[i])
+            own_scratch.push_back(entity_from_snapshot(sessions.states[i]));
+    }
+
+    shared.world.publish(index, own_scratch.data(), own_scratch.size());
+
+    WorldFrame& cur = world_history[current_tick % WORLD_HISTORY];
+    cur.tick = current_tick;
+    cur.entities.clear();
+    shared.world.read_all(cur.entities);
+
+    std::sort(cur.entities.begin(), cur.entities.end(),
+        [](const EntityState& a, const EntityState& b) {
+            return a.player_id < b.player_id;
+        });
+
+    history.record(current_tick, cur.entities.data(), cur.entities.size());
+
+    grid.clear();
+    for (const EntityState& e : cur.entities)
+        grid.insert(e.player_id, e.x, e.z);
+}
+
+// Everything a client gets this tick (its PlayerState, world parts and
+// reliable messages) is coalesced into as few datagrams as possible
+void ServerWorker::broadcast_world() {
+    const WorldFrame& cur = world_history[current_tick % WORLD_HISTORY];
+    const uint32_t slot = current_tick % WORLD_HISTORY;
+    const double now = clock_now();
+
+    // Room for the bundle framing, so a full reliable packet can still
+    // go out as part of one
+    constexpr size_t RELIABLE_ROOM =
+        BUNDLE_MTU - sizeof(BundleHeader) - BUNDLE_RECORD_BYTES;
+    uint8_t reliable_packet[RELIABLE_ROOM];
+
+    // Recipient-major order keeps sends to one address back to back
+    // so GSO can coalesce them.
+    for (size_t s = 0; s < sessions.size(); ++s) {
+        const sockaddr_in& addr = sessions.addrs[s];
+
+        // Exact own state for prediction, ahead of the quantized world
+        const SimPlayer& body = sessions.bodies[s];
+        PlayerState own{};
+        own.tick       = current_tick;
+        own.input_tick = sessions.inputs[s].applied_tick();
+        own.x = body.x; own.y = body.y; own.z = body.z;
+        own.yaw   = body.yaw;
+        own.pitch = body.pitch;
+        own.tick_rate = uint8_t(shared.config.tick_rate);
+        own.acks      = sessions.reliable[s].acks();
+        coalesce(&own, sizeof(own), addr, PacketKind::PLAYER_STATE);
+
+        ClientView& v = views[session_slot(sessions.ids[s])];
+        update_relevance(int32_t(s), v);
+
+        // Baseline: the acked frame, restricted to what this client got
+        uint32_t base_tick = sessions.acked_tick[s];
+        const WorldFrame* base = baseline_frame(base_tick);
+
+        if (base && v.sent_tick[base_tick % WORLD_HISTORY] != base_tick)
+            base = nullptr;
+
+        baseline_scratch.clear();
+        if (base) {
+            for (uint32_t id : v.sent[base_tick % WORLD_HISTORY]) {
+                if (const EntityState* e = find_entity(
+                        base->entities.data(), base->entities.size(), id))
+                    baseline_scratch.push_back(*e);
+            }
+        }
+
+        // Accumulate priority, then take the highest-priority entities
+        // that fit the budget. Smaller records may still fill the gap
+        // behind one that does not fit.
+        const uint32_t pid = sessions.ids[s];
+        const float x = sessions.states[s].x;
+        const float z = sessions.states[s].z;
+
+        candidates.clear();
+        for (size_t k = 0; k < v.relevant.size(); ++k) {
+            const EntityState* e = find_entity(
+                cur.entities.data(), cur.entities.size(), v.relevant[k]);
+            if (!e)
+                continue;
+
+            Track& t = v.tracks[k];
+            if (e->player_id == pid)
+                t.priority = PRIORITY_SELF;
+            else
+                t.priority += priority_gain(*e, t, x, z);
+
+            candidates.push_back({ t.priority, uint32_t(k), e });
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+                return a.priority > b.priority;
+            });
+
+        const size_t budget = shared.config.client_budget;
+        size_t record_bits = 0;
+
+        chosen.clear();
+        for (const Candidate& c : candidates) {
+            size_t bits = world_record_bits(*c.entity,
+                find_entity(baseline_scratch.data(), baseline_scratch.size(),
+                            c.entity->player_id));
+
+            if (world_snapshot_max_bytes(record_bits + bits) > budget)
+                continue;
+
+            record_bits += bits;
+            chosen.push_back(c);
+        }
+
+        // Ascending ids let the records use the sequential-id bit
+        std::sort(chosen.begin(), chosen.end(),
+            [](const Candidate& a, const Candidate& b) {
+                return a.entity->player_id < b.entity->player_id;
+            });
+
+        current_scratch.clear();
+        for (const Candidate& c : chosen)
+            current_scratch.push_back(*c.entity);
+
+        size_t written = 0;
+        size_t part_count = encode_world_snapshot(
+            cur.tick, uint8_t(shared.config.tick_rate),
+            current_scratch.data(), current_scratch.size(),
+            base ? base_tick : 0,
+            baseline_scratch.data(), baseline_scratch.size(),
+            world_parts, &written);
+
+        v.sent_tick[slot] = cur.tick;
+        v.sent[slot].clear();
+        for (size_t i = 0; i < written; ++i) {
+            const EntityState& e = current_scratch[i];
+            v.sent[slot].push_back(e.player_id);
+
+            Track& t = v.tracks[chosen[i].track];
+            t.priority      = 0.0f;
+            t.waiting_since = cur.tick;
+            t.vx = e.vx; t.vy = e.vy; t.vz = e.vz;
+        }
+
+        // Whatever stayed behind keeps its priority for next tick
+        for (const Track& t : v.tracks) {
+            uint32_t wait = cur.tick - t.waiting_since;
+            if (wait == 0)
+                continue;
+
+            world_deferred += 1;
+            if (wait >= uint32_t(shared.config.tick_rate))
+                world_starved += 1;
+            world_max_wait = std::max(world_max_wait, wait);
+        }
+
+        for (size_t i = 0; i < part_count; ++i) {
+            coalesce(world_parts[i].bytes, world_parts[i].size, addr,
+                PacketKind::WORLD_SNAPSHOT);
+            world_bytes += world_parts[i].size;
+        }
+
+        // New reliable messages, and old ones due for a resend
+        if (size_t n = sessions.reliable[s].write(reliable_packet,
+                sizeof(reliable_packet), now, reliable_stats))
+            coalesce(reliable_packet, n, addr, PacketKind::RELIABLE);
+
+        coalescer.flush([&](const uint8_t* data, size_t size) {
+            send_datagram(data, size, addr);
+        });
+
+        world_sends    += 1;
+        world_budget   += budget;
+        world_relevant += v.relevant.size();
+        if (!base)
+            world_keyframes += 1;
+    }
+
+    flush_sends();
+
+    metrics.reliable_resent.add(reliable_stats.resent);
+    metrics.reliable_dropped.add(reliable_stats.dropped);
+    reliable_stats = ReliableStats{};
+}
+
+// ------------------------------------------------------------
+// Session timers
+// ------------------------------------------------------------
+void ServerWorker::expire_timers() {
+    expired_scratch.clear();
+    timers.advance(current_tick, expired_scratch);
+
+    for (uint32_t id : expired_scratch) {
+        int32_t s = sessions.find_id(id);
+        if (s == NO_SESSION)
+            continue; // already gone
+
+        // Heard from since arming: check again one timeout after that
+        uint32_t due = sessions.last_seen[s] + idle_ticks;
+        if (due > current_tick) {
+            sessions.idle_timer[s] = timers.arm(due, id);
+            continue;
+        }
+
+        printf("%s evicted id=%u (idle %us)\n", tag.c_str(), id,
+            (current_tick - sessions.last_seen[s]) /
+            uint32_t(shared.config.tick_rate));
+        evict(s);
+    }
+}
+
+void ServerWorker::evict(int32_t s) {
+    timers.cancel(sessions.idle_timer[s]);
+    sessions.close(s);
+    ++evictions;
+    metrics.evictions.add();
+}
+
+// ------------------------------------------------------------
+// Loop
+// ------------------------------------------------------------
+void ServerWorker::ingest(const uint8_t* data, size_t size,
+                          const sockaddr_in& from) {
+    PacketRef packet = pool.copy(data, size);
+    if (packet)
+        ingest(packet, from);
+}
+
+void ServerWorker::ingest(PacketRef& packet, const sockaddr_in& from) {
+    metrics.bytes_in.add(packet.size());
+    handle_packet(packet, from);
+}
+
+void ServerWorker::tick(uint32_t ticks) {
+    uint64_t start = monotonic_ns();
+
+    // Missed timer expirations still step the simulation; the world
+    // only goes out for the newest tick
+    for (uint32_t k = 0; k < ticks; ++k) {
+        ++current_tick;
+        simulate();
+    }
+
+    expire_timers();
+    gather_world();
+    step_missiles(ticks);
+    broadcast_world();
+    metrics.tick_ns.record(monotonic_ns() - start);
+    metrics.sessions.set(sessions.size());
+
+    const PacketPoolStats ps = pool.stats();
+    metrics.packet_buffers.set(ps.in_use);
+    metrics.packet_buffers_allocated.set(ps.capacity);
+    metrics.packet_buffers_exhausted.set(ps.exhausted);
+    ++stats_ticks;
+}
+
+void ServerWorker::run() {
+    while (true) {
+        epoll_event events[3];
+        int n = epoll_wait(epfd, events, 3, -1);
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+
+            if (fd == sockfd) {
+                drain_socket();
+                continue;
+            }
+
+            if (fd == eventfd) {
+                drain_inbox();
+                continue;
+            }
+
+            uint64_t expirations = 0;
+            if (read(timerfd, &expirations, sizeof(expirations)) !=
+                sizeof(expirations))
+                continue;
+
+            // A late wakeup simulates every missed tick; only the newest
+            // one's world is broadcast
+            tick(uint32_t(expirations));
+            report_stats(clock_now());
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// Stats
+// ------------------------------------------------------------
+void ServerWorker::report_stats(double now) {
+    if (now < next_stats_time)
+        return;
+
+    next_stats_time = now + STATS_INTERVAL;
+
+    if (rx->syscalls > 0) {
+        printf("%s recv %llu datagrams / %llu syscalls (%.2f per call)\n",
+            tag.c_str(),
+            (unsigned long long)rx->datagrams,
+            (unsigned long long)rx->syscalls,
+            rx->datagrams_per_syscall());
+    }
+
+    if (tx->batches > 0 && stats_ticks > 0) {
+        printf("%s send %llu datagrams / %llu syscalls, "
+               "%.1f syscalls saved per tick, %llu errors\n",
+            tag.c_str(),
+            (unsigned long long)tx->datagrams,
+            (unsigned long long)tx->syscalls,
+            double(tx->syscalls_saved()) / double(stats_ticks),
+            (unsigned long long)tx->errors);
+    }
+
+    if (world_sends > 0) {
+        printf("%s world %.0f bytes per client update, "
+               "%.1f relevant entities, %llu keyframes / %llu updates\n",
+            tag.c_str(),
+            double(world_bytes) / double(world_sends),
+            double(world_relevant) / double(world_sends),
+            (unsigned long long)world_keyframes,
+            (unsigned long long)world_sends);
+
+        printf("%s budget %.0f%% used, %.1f entities deferred per update, "
+               "%llu starved (>1s), longest wait %u ticks\n",
+            tag.c_str(),
+            100.0 * double(world_bytes) / double(world_budget),
+            double(world_deferred) / double(world_sends),
+            (unsigned long long)world_starved,
+            world_max_wait);
+    }
+
+    const PacketPoolStats ps = pool.stats();
+    if (ps.capacity > 0) {
+        printf("%s packet buffers %zu in use, %zu peak, %zu allocated, "
+               "%llu refused\n",
+            tag.c_str(), ps.in_use, ps.peak, ps.capacity,
+            (unsigned long long)ps.exhausted);
+    }
+
+    if (rx->dropped > 0) {
+        printf("%s %llu datagrams dropped with no packet buffer free\n",
+            tag.c_str(), (unsigned long long)rx->dropped);
+    }
+
+    if (evictions > 0) {
+        printf("%s %llu idle sessions evicted, %zu active\n",
+            tag.c_str(),
+            (unsigned long long)evictions,
+            sessions.size());
+    }
+
+    rx->reset_stats();
+    tx->reset_stats();
+    errors_counted  = 0;
+    stats_ticks     = 0;
+    world_bytes     = 0;
+    world_sends     = 0;
+    world_keyframes = 0;
+    world_relevant  = 0;
+    evictions       = 0;
+    world_budget    = 0;
+    world_deferred  = 0;
+    world_starved   = 0;
+    world_max_wait  = 0;
+}
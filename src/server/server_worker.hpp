@@ -0,0 +1,308 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <netinet/in.h>
+
+#include "sentinel/net/buffer/packet_pool.hpp"
+#include "sentinel/net/protocol/snapshot.hpp"
+#include "sentinel/net/protocol/chat.hpp"
+#include "sentinel/net/protocol/dispatch.hpp"
+#include "sentinel/net/protocol/reliable.hpp"
+#include "sentinel/net/protocol/world_snapshot.hpp"
+#include "sentinel/sim/missile.hpp"
+
+#include "capture.hpp"
+#include "coalescer.hpp"
+#include "interest_grid.hpp"
+#include "lag_history.hpp"
+#include "metrics.hpp"
+#include "missile_table.hpp"
+#include "session_table.hpp"
+#include "timing_wheel.hpp"
+#include "udp_batch.hpp"
+#include "world_table.hpp"
+
+class ServerWorker;
+
+struct ServerConfig {
+    uint16_t port      = 7777;
+    int      tick_rate = 30;
+    bool     gso       = false;
+    size_t   workers   = 1;
+    int      idle_timeout = 10; // seconds of silence before eviction
+    size_t   client_budget = 4 * WORLD_SNAPSHOT_MTU; // world bytes per tick
+    uint32_t input_delay   = 2; // ticks of input jitter absorbed
+
+    std::string capture_path;          // ingress capture, empty = off
+
+    std::string metrics_socket;        // UNIX socket path, empty = off
+    std::string metrics_file;          // Prometheus textfile, empty = off
+    int         metrics_interval = 10; // seconds between file writes
+};
+
+// State every worker can see
+struct ServerShared {
+    explicit ServerShared(const ServerConfig& c)
+        : config(c), world(c.workers) {}
+
+    ServerConfig config;
+    WorldTable   world;
+
+    // tick 0; every worker's timer is phase-locked to it
+    timespec epoch{};
+
+    // Seconds on the epoch's timeline; empty = CLOCK_MONOTONIC. A
+    // simulated network's virtual clock goes here.
+    std::function<double()> clock;
+
+    std::vector<ServerWorker*> workers;
+};
+
+// ------------------------------------------------------------
+// ServerWorker
+// ------------------------------------------------------------
+// Owns one SO_REUSEPORT socket and every session the kernel hashes to
+// it. Ingest, the world tick and fan-out for those clients all run on
+// the worker's thread; other workers' players come from the WorldTable.
+class ServerWorker {
+public:
+    ServerWorker(ServerShared& shared, size_t index);
+    ~ServerWorker();
+
+    bool open();
+    void run();
+
+    // Instead of open() and run(): the worker's datagrams come from
+    // and go to `socket` (a SimNetwork's, say), and the caller drives
+    // poll() and tick(). The socket must outlive the worker.
+    void attach(UdpSocket& socket);
+    void poll(); // ingests what has arrived, then cross-worker events
+
+    // The socket path in run() is just these two; a replay driver can
+    // call them directly on a worker that was never opened (its sends
+    // are counted and dropped). Raw bytes are copied into the pool.
+    void ingest(const uint8_t* data, size_t size, const sockaddr_in& from);
+    void ingest(PacketRef& packet, const sockaddr_in& from);
+    void tick(uint32_t ticks = 1);
+
+    // Thread-safe; queues an event for this worker's clients
+    void post_event(const void* data, size_t size,
+                    float x, float z, bool global);
+
+    // Written only by this worker's thread; safe to read from any
+    WorkerMetrics metrics;
+
+private:
+    // ---- delta baselines ----
+    static constexpr uint32_t WORLD_HISTORY = 32;
+
+    struct WorldFrame {
+        uint32_t tick = 0;
+        std::vector<EntityState> entities; // sorted by player_id
+    };
+
+    // Send priority of one relevant entity. Priority accumulates every
+    // tick the entity is held back and resets when it goes out.
+    struct Track {
+        float    priority = 0.0f;
+        uint32_t waiting_since = 0;         // tick of last send or entry
+        float    vx = 0.0f, vy = 0.0f, vz = 0.0f; // as last sent
+    };
+
+    // What one client can see, and what it was actually sent. Deltas
+    // are only valid against entities the client received on the
+    // acked tick.
+    struct ClientView {
+        std::vector<uint32_t> relevant; // sorted
+        std::vector<Track>    tracks;   // parallel to relevant
+
+        uint32_t              sent_tick[WORLD_HISTORY] = {};
+        std::vector<uint32_t> sent[WORLD_HISTORY];     // sorted
+    };
+
+    // Chat / missile events crossing from another worker
+    static constexpr size_t RELAY_MAX_BYTES = sizeof(ChatMessage);
+
+    struct RelayedEvent {
+        uint8_t bytes[RELAY_MAX_BYTES];
+        size_t  size;
+        float   x, z;
+        bool    global;
+    };
+
+    // ---- ingress ----
+    // `packet` is the view being dispatched, so a handler can patch
+    // it and relay the same bytes
+    struct PacketContext {
+        const sockaddr_in& from;
+        uint64_t           key;
+        int32_t            session; // NO_SESSION before HELLO
+        PacketRef*         packet;
+    };
+
+    using Dispatch = PacketDispatcher<ServerWorker, PacketContext,
+        Hello, InputCmd, SnapshotAck, ReliablePacket>;
+    friend Dispatch;
+
+    // Messages that only arrive inside a RELIABLE packet
+    using ReliableDispatch = PacketDispatcher<ServerWorker, PacketContext,
+        ChatMessage, MissileFireEvent, MissileExplodeEvent>;
+    friend ReliableDispatch;
+
+    void handle_packet(PacketRef& packet, const sockaddr_in& from);
+
+    // Counts the packet; false if the sender has no session
+    bool admit(const PacketContext& ctx, PacketKind kind);
+
+    void on_packet(const Hello& p, const PacketContext& ctx);
+    void on_packet(const ChatMessage& p, const PacketContext& ctx);
+    void on_packet(const InputCmd& p, const PacketContext& ctx);
+    void on_packet(const SnapshotAck& p, const PacketContext& ctx);
+    void on_packet(const ReliablePacket& p, const uint8_t* data, size_t size,
+                   const PacketContext& ctx);
+    void on_packet(const MissileFireEvent& p, const PacketContext& ctx);
+    void on_packet(const MissileExplodeEvent& p, const PacketContext& ctx);
+
+    double tick_time(uint32_t tick) const; // seconds on shared.clock
+    double clock_now() const;
+
+    // Events fan out as views of one pooled buffer; the raw overload
+    // copies into the pool first
+    void relay_event(const void* data, size_t size,
+                     float x, float z, bool global);
+    void relay_event(const PacketRef& ev, float x, float z, bool global);
+    void send_local(const PacketRef& ev, float x, float z, bool global);
+
+    // Writes p over the bytes it arrived in and relays them
+    template <class T>
+    void relay_patched(const PacketContext& ctx, const T& p,
+                       float x, float z, bool global);
+
+    // send_to() is a datagram of its own; coalesce() joins the current
+    // client's bundle, which broadcast_world() flushes per client
+    void send_to(const void* data, size_t size, const sockaddr_in& to,
+                 PacketKind kind);
+    void send_datagram(const void* data, size_t size, const sockaddr_in& to);
+    void coalesce(const void* data, size_t size, const sockaddr_in& to,
+                  PacketKind kind);
+    void flush_sends();
+
+    void drain_socket();
+    void drain_inbox();
+
+    void simulate();
+
+    const WorldFrame* baseline_frame(uint32_t tick) const;
+    void update_relevance(int32_t s, ClientView& v);
+    float priority_gain(const EntityState& e, const Track& t,
+                        float x, float z) const;
+    void gather_world();
+    void broadcast_world();
+    void step_missiles(uint32_t ticks);
+
+    void expire_timers();
+    void evict(int32_t s);
+
+    void report_stats(double now);
+
+    ServerShared& shared;
+    size_t        index;
+    std::string   tag; // log prefix
+
+    int sockfd  = -1;
+    int timerfd = -1;
+    UdpSocket* io = nullptr; // attach()ed in place of sockfd
+    int eventfd = -1; // wakes the loop when the inbox fills
+    int epfd    = -1;
+
+    // Receive buffers and the events held by reliable channels. Comes
+    // before everything that can hold a view of it.
+    PacketPool pool;
+
+    std::unique_ptr<RecvBatch> rx;
+    std::unique_ptr<SendBatch> tx;
+
+    std::unique_ptr<CaptureWriter> capture;
+
+    uint32_t current_tick = 0;
+
+    // ---- sessions ----
+    SessionTable sessions;
+
+    // indexed by session slot, which survives swap-removes
+    std::vector<ClientView> views;
+
+    // Idle timers are armed once per session and re-armed lazily when
+    // they fire, so packets never touch the wheel
+    TimingWheel           timers;
+    uint32_t              idle_ticks = 0;
+    std::vector<uint32_t> expired_scratch;
+
+    // ---- simulation ----
+    SimWorld              sim_world;
+    float                 sim_dt = 0.0f;
+    InputStats            input_stats; // folded into metrics per tick
+    ReliableStats         reliable_stats; // likewise
+    std::vector<SimInput> input_scratch;
+
+    // ---- lag compensation ----
+    // Hit tests rewind by the shooter's RTT plus the client's
+    // interpolation delay
+    LagHistory            history;
+    uint32_t              interp_ticks = 0;
+
+    // ---- outbound ----
+    PacketCoalescer coalescer; // one client at a time
+
+    // ---- projectiles ----
+    MissileTable               missiles;
+    HitGrid                    hit_grid;
+    std::vector<MissileImpact> impact_scratch;
+
+    // ---- world ----
+    WorldFrame   world_history[WORLD_HISTORY];
+    InterestGrid grid;
+
+    std::vector<EntityState> own_scratch;
+    std::vector<uint32_t>    relevant_scratch;
+    std::vector<Track>       tracks_scratch;
+    std::vector<EntityState> current_scratch;
+    std::vector<EntityState> baseline_scratch;
+    std::vector<WorldPacket> world_parts;
+
+    struct Candidate {
+        float              priority;
+        uint32_t           track;
+        const EntityState* entity;
+    };
+    std::vector<Candidate> candidates;
+    std::vector<Candidate> chosen;
+
+    // ---- cross-worker events ----
+    // Events are rare next to state traffic, so a mutex is fine here
+    std::mutex                inbox_lock;
+    std::vector<RelayedEvent> inbox;
+    std::vector<RelayedEvent> inbox_scratch;
+
+    // ---- stats ----
+    double   next_stats_time = 0.0;
+    uint64_t stats_ticks     = 0;
+    uint64_t world_bytes     = 0;
+    uint64_t world_sends     = 0; // client updates
+    uint64_t world_keyframes = 0;
+    uint64_t world_relevant  = 0; // entities considered, summed
+    uint64_t evictions       = 0;
+    uint64_t errors_counted  = 0; // tx->errors already in metrics
+    uint64_t world_budget    = 0; // bytes allowed, summed
+    uint64_t world_deferred  = 0; // relevant entities held back
+    uint64_t world_starved   = 0; // ... for longer than a second
+    uint32_t world_max_wait  = 0; // ticks
+};
@@ -0,0 +1,166 @@
+#include "session_table.hpp"
+
+#include <cstring>
+#include <utility>
+
+SessionTable::SessionTable(uint32_t w)
+    : ids(SESSION_CAPACITY), keys(SESSION_CAPACITY),
+      addrs(SESSION_CAPACITY), states(SESSION_CAPACITY),
+      has_state(SESSION_CAPACITY), bodies(SESSION_CAPACITY),
+      inputs(SESSION_CAPACITY), acked_tick(SESSION_CAPACITY),
+      rtt_ticks(SESSION_CAPACITY), reliable(SESSION_CAPACITY),
+      last_seen(SESSION_CAPACITY), idle_timer(SESSION_CAPACITY, NO_TIMER),
+      names(SESSION_CAPACITY),
+      generation(SESSION_CAPACITY), slot_to_dense(SESSION_CAPACITY, NO_SESSION),
+      index(INDEX_CAPACITY, IndexEntry{ EMPTY_KEY, 0 }),
+      worker(w) {
+    // Pop order hands out slot 0 first
+    for (size_t i = SESSION_CAPACITY; i > 0; --i)
+        free_slots.push_back(uint32_t(i - 1));
+}
+
+// ------------------------------------------------------------
+// Address index
+// ------------------------------------------------------------
+size_t SessionTable::probe_start(uint64_t key) const {
+    // splitmix64 finalizer; addr keys are far from uniform
+    key ^= key >> 30; key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27; key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return size_t(key) & (INDEX_CAPACITY - 1);
+}
+
+void SessionTable::index_insert(uint64_t key, uint32_t slot) {
+    size_t i = probe_start(key);
+    while (index[i].key != EMPTY_KEY)
+        i = (i + 1) & (INDEX_CAPACITY - 1);
+
+    index[i] = { key, slot };
+}
+
+void SessionTable::index_erase(uint64_t key) {
+    size_t i = probe_start(key);
+    while (index[i].key != key) {
+        if (index[i].key == EMPTY_KEY)
+            return;
+        i = (i + 1) & (INDEX_CAPACITY - 1);
+    }
+
+    // Backward-shift: pull later entries of the run into the hole if
+    // their home position does not lie between the hole and them.
+    size_t hole = i;
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & (INDEX_CAPACITY - 1);
+        if (index[j].key == EMPTY_KEY)
+            break;
+
+        size_t home = probe_start(index[j].key);
+        bool between = hole <= j ? (hole < home && home <= j)
+                                 : (hole < home || home <= j);
+        if (between)
+            continue;
+
+        index[hole] = index[j];
+        hole = j;
+    }
+
+    index[hole].key = EMPTY_KEY;
+}
+
+int32_t SessionTable::find(uint64_t key) const {
+    size_t i = probe_start(key);
+    while (index[i].key != EMPTY_KEY) {
+        if (index[i].key == key)
+            return slot_to_dense[index[i].slot];
+        i = (i + 1) & (INDEX_CAPACITY - 1);
+    }
+
+    return NO_SESSION;
+}
+
+int32_t SessionTable::find_id(uint32_t id) const {
+    uint32_t slot = session_slot(id);
+    if (slot >= SESSION_CAPACITY)
+        return NO_SESSION;
+
+    int32_t dense = slot_to_dense[slot];
+    if (dense == NO_SESSION || ids[dense] != id)
+        return NO_SESSION; // stale generation
+
+    return dense;
+}
+
+// ------------------------------------------------------------
+// Open / close
+// ------------------------------------------------------------
+int32_t SessionTable::open(uint64_t key, const sockaddr_in& addr) {
+    if (full() || find(key) != NO_SESSION)
+        return NO_SESSION;
+
+    uint32_t slot = free_slots.back();
+    free_slots.pop_back();
+
+    // Generation 0 is skipped so no id is ever 0
+    uint16_t gen = uint16_t((generation[slot] + 1) &
+                            ((1u << SESSION_GEN_BITS) - 1));
+    if (gen == 0)
+        gen = 1;
+    generation[slot] = gen;
+
+    int32_t d = int32_t(count++);
+    slot_to_dense[slot] = d;
+
+    ids[d] = (uint32_t(gen) << (SESSION_SLOT_BITS + SESSION_WORKER_BITS)) |
+             (worker << SESSION_SLOT_BITS) | slot;
+    keys[d]       = key;
+    addrs[d]      = addr;
+    states[d]     = Snapshot{};
+    has_state[d]  = 0;
+    bodies[d]     = SimPlayer{};
+    inputs[d]     = InputBuffer{};
+    acked_tick[d] = 0;
+    rtt_ticks[d]  = 0.0f;
+    reliable[d]   = ReliableChannel{};
+    last_seen[d]  = 0;
+    idle_timer[d] = NO_TIMER;
+    std::memset(names[d].text, 0, sizeof(names[d].text));
+
+    index_insert(key, slot);
+    return d;
+}
+
+void SessionTable::close(int32_t d) {
+    if (d < 0 || size_t(d) >= count)
+        return;
+
+    uint32_t slot = session_slot(ids[d]);
+
+    index_erase(keys[d]);
+    slot_to_dense[slot] = NO_SESSION;
+    free_slots.push_back(slot);
+
+    // Swap-remove keeps the arrays dense
+    int32_t last = int32_t(--count);
+    if (d != last) {
+        ids[d]        = ids[last];
+        keys[d]       = keys[last];
+        addrs[d]      = addrs[last];
+        states[d]     = states[last];
+        has_state[d]  = has_state[last];
+        bodies[d]     = bodies[last];
+        inputs[d]     = inputs[last];
+        acked_tick[d] = acked_tick[last];
+        rtt_ticks[d]  = rtt_ticks[last];
+        // Moved: the window is ~10 KB and holds pool references
+        reliable[d]   = std::move(reliable[last]);
+        last_seen[d]  = last_seen[last];
+        idle_timer[d] = idle_timer[last];
+        names[d]      = names[last];
+
+        slot_to_dense[session_slot(ids[d])] = d;
+    }
+
+    // Let go of pooled messages now rather than when the slot reopens
+    reliable[last] = ReliableChannel{};
+}
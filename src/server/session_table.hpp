@@ -0,0 +1,115 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include "sentinel/net/protocol/snapshot.hpp"
+#include "sentinel/net/protocol/chat.hpp"
+#include "sentinel/net/reliable/reliable_channel.hpp"
+
+#include "input_buffer.hpp"
+#include "timing_wheel.hpp"
+
+// ------------------------------------------------------------
+// Session table
+// ------------------------------------------------------------
+// Fixed-capacity store for one worker's clients.
+//
+// Player ids are generational: [generation:10][worker:6][slot:16].
+// A slot is reused only with a bumped generation, so a stale id never
+// resolves to the next client in that slot. The worker bits keep ids
+// unique across SO_REUSEPORT workers without any shared counter.
+//
+// Per-client data lives in dense parallel arrays indexed 0..size()-1,
+// so fan-out walks contiguous memory. Closing a session moves the last
+// entry into the hole; dense indices are therefore only stable until
+// the next close().
+
+constexpr size_t   SESSION_CAPACITY   = 4096;  // per worker
+constexpr uint32_t SESSION_SLOT_BITS  = 16;
+constexpr uint32_t SESSION_WORKER_BITS = 6;
+constexpr uint32_t SESSION_GEN_BITS   = 10;
+constexpr int32_t  NO_SESSION         = -1;
+
+static_assert(SESSION_CAPACITY <= (size_t(1) << SESSION_SLOT_BITS),
+              "slot index must fit its id bits");
+
+class SessionTable {
+public:
+    explicit SessionTable(uint32_t worker);
+
+    size_t size() const { return count; }
+    bool   full() const { return count == SESSION_CAPACITY; }
+
+    // Creates a session for a new address. Returns its dense index, or
+    // NO_SESSION if the table is full or the address is known.
+    int32_t open(uint64_t addr_key, const sockaddr_in& addr);
+
+    void close(int32_t index);
+
+    int32_t find(uint64_t addr_key) const;
+    int32_t find_id(uint32_t id) const;
+
+    // ---- dense per-client arrays, valid for [0, size()) ----
+    std::vector<uint32_t>    ids;
+    std::vector<uint64_t>    keys;
+    std::vector<sockaddr_in> addrs;
+    std::vector<Snapshot>    states;     // as of the last simulated tick
+    std::vector<uint8_t>     has_state;  // states[i] is meaningful
+    std::vector<SimPlayer>   bodies;     // authoritative sim state
+    std::vector<InputBuffer> inputs;     // pending InputCmds
+    std::vector<uint32_t>    acked_tick; // newest world tick fully received
+    std::vector<float>       rtt_ticks;  // smoothed round trip, from acks
+    std::vector<ReliableChannel> reliable; // chat and events, both ways
+    std::vector<uint32_t>    last_seen;  // tick of the last packet
+    std::vector<TimerId>     idle_timer; // pending idle check
+
+    struct Name { char text[MAX_NAME_LEN]; };
+    std::vector<Name>        names;      // empty until the first chat
+
+private:
+    // ---- slot bookkeeping (indexed by slot) ----
+    std::vector<uint16_t> generation;
+    std::vector<int32_t>  slot_to_dense;
+    std::vector<uint32_t> free_slots;
+
+    // ---- open-addressing addr_key -> slot index ----
+    // Linear probing at a load factor of at most 1/2; deletes shift
+    // later entries back instead of leaving tombstones.
+    static constexpr size_t   INDEX_CAPACITY = SESSION_CAPACITY * 2;
+    static constexpr uint64_t EMPTY_KEY      = ~uint64_t(0);
+
+    struct IndexEntry {
+        uint64_t key;
+        uint32_t slot;
+    };
+
+    size_t probe_start(uint64_t key) const;
+    void   index_insert(uint64_t key, uint32_t slot);
+    void   index_erase(uint64_t key);
+
+    std::vector<IndexEntry> index;
+
+    uint32_t worker;
+    size_t   count = 0;
+};
+
+// Sessions are keyed by IPv4 address and port
+inline uint64_t addr_key(const sockaddr_in& a) {
+    return (uint64_t(a.sin_addr.s_addr) << 16) | ntohs(a.sin_port);
+}
+
+inline sockaddr_in addr_from_key(uint64_t key) {
+    sockaddr_in a{};
+    a.sin_family      = AF_INET;
+    a.sin_addr.s_addr = uint32_t(key >> 16);
+    a.sin_port        = htons(uint16_t(key & 0xFFFF));
+    return a;
+}
+
+inline uint32_t session_slot(uint32_t id) {
+    return id & ((uint32_t(1) << SESSION_SLOT_BITS) - 1);
+}
@@ -0,0 +1,152 @@
+#include "timing_wheel.hpp"
+
+#include <algorithm>
+
+TimingWheel::TimingWheel(size_t capacity) : nodes(capacity) {
+    if (nodes.size() > INDEX_MASK)
+        nodes.resize(INDEX_MASK);
+
+    for (size_t i = nodes.size(); i > 0; --i)
+        free_nodes.push_back(uint32_t(i - 1));
+
+    for (auto& level : heads)
+        for (auto& head : level)
+            head = NIL;
+}
+
+// ------------------------------------------------------------
+// Slot lists
+// ------------------------------------------------------------
+uint32_t& TimingWheel::list_head(const Node& n) {
+    return n.level == LEVELS ? overflow : heads[n.level][n.slot];
+}
+
+void TimingWheel::link(uint32_t i) {
+    Node& n = nodes[i];
+
+    // Lowest level at which deadline and now share every higher digit
+    uint32_t level = 0;
+    while (level < LEVELS &&
+           (n.deadline >> (SLOT_BITS * (level + 1))) !=
+           (current    >> (SLOT_BITS * (level + 1))))
+        ++level;
+
+    n.level = uint8_t(level);
+    n.slot  = level == LEVELS ? 0 :
+              uint8_t((n.deadline >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+    uint32_t& head = list_head(n);
+    n.prev = NIL;
+    n.next = head;
+    if (head != NIL)
+        nodes[head].prev = i;
+    head = i;
+}
+
+void TimingWheel::unlink(uint32_t i) {
+    Node& n = nodes[i];
+
+    if (n.prev != NIL)
+        nodes[n.prev].next = n.next;
+    else
+        list_head(n) = n.next;
+
+    if (n.next != NIL)
+        nodes[n.next].prev = n.prev;
+
+    n.prev = n.next = NIL;
+}
+
+void TimingWheel::release(uint32_t i) {
+    nodes[i].live = false;
+    nodes[i].gen  = uint16_t(nodes[i].gen + 1);
+    free_nodes.push_back(i);
+    --armed;
+}
+
+// ------------------------------------------------------------
+// Arm / cancel
+// ------------------------------------------------------------
+TimerId TimingWheel::arm(uint64_t deadline, uint32_t user) {
+    if (free_nodes.empty())
+        return NO_TIMER;
+
+    if (deadline <= current)
+        deadline = current + 1;
+
+    uint32_t i = free_nodes.back();
+    free_nodes.pop_back();
+
+    Node& n = nodes[i];
+    n.deadline = deadline;
+    n.user     = user;
+    n.live     = true;
+    link(i);
+    ++armed;
+
+    // 12 generation bits above the node index
+    return (TimerId(n.gen & 0xFFF) << INDEX_BITS) | i;
+}
+
+void TimingWheel::cancel(TimerId id) {
+    if (id == NO_TIMER)
+        return;
+
+    uint32_t i = id & INDEX_MASK;
+    if (i >= nodes.size())
+        return;
+
+    Node& n = nodes[i];
+    if (!n.live || (n.gen & 0xFFF) != (id >> INDEX_BITS))
+        return; // already fired or cancelled
+
+    unlink(i);
+    release(i);
+}
+
+// ------------------------------------------------------------
+// Advance
+// ------------------------------------------------------------
+void TimingWheel::cascade(uint32_t& head) {
+    uint32_t i = head;
+    head = NIL;
+
+    // Re-file against the new time; each timer drops at least a level
+    // (overflow timers may stay put)
+    while (i != NIL) {
+        uint32_t next = nodes[i].next;
+        link(i);
+        i = next;
+    }
+}
+
+void TimingWheel::advance(uint64_t now, std::vector<uint32_t>& expired) {
+    while (current < now) {
+        ++current;
+
+        // Highest wrapped level first, so its timers land in slots the
+        // lower cascades below still visit
+        uint32_t top = 0;
+        while (top < LEVELS &&
+               (current & ((uint64_t(1) << (SLOT_BITS * (top + 1))) - 1)) == 0)
+            ++top;
+
+        if (top == LEVELS)
+            cascade(overflow);
+
+        for (uint32_t level = std::min(top, LEVELS - 1); level > 0; --level)
+            cascade(heads[level][(current >> (SLOT_BITS * level)) & (SLOTS - 1)]);
+
+        uint32_t slot = uint32_t(current) & (SLOTS - 1);
+        uint32_t i = heads[0][slot];
+        heads[0][slot] = NIL;
+
+        while (i != NIL) {
+            uint32_t next = nodes[i].next;
+            expired.push_back(nodes[i].user);
+            nodes[i].prev = nodes[i].next = NIL;
+            release(i);
+            i = next;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ------------------------------------------------------------
+// Hierarchical timing wheel
+// ------------------------------------------------------------
+// Deadlines are in server ticks. Level 0 has one slot per tick; each
+// level above covers 64x the span of the one below. A timer sits at
+// the lowest level whose span still reaches its deadline and moves
+// down a level (cascades) when the wheel below wraps. Deadlines past
+// the top wheel wait on an overflow list until it wraps.
+//
+// arm() and cancel() are O(1). advance() touches only the slots the
+// clock passes through, so cost scales with expiring timers, not with
+// armed ones.
+//
+// Timers carry a 32-bit user value (e.g. a session id). Handles are
+// generational: cancelling a timer that already fired is a no-op even
+// if its node has been reused.
+
+using TimerId = uint32_t;
+constexpr TimerId NO_TIMER = ~TimerId(0);
+
+class TimingWheel {
+public:
+    static constexpr uint32_t SLOT_BITS = 6;
+    static constexpr uint32_t SLOTS     = 1u << SLOT_BITS;
+    static constexpr uint32_t LEVELS    = 4;  // 2^24 ticks, ~6 days @ 30 Hz
+
+    explicit TimingWheel(size_t capacity);
+
+    // Fires on the first advance() that reaches deadline. Deadlines in
+    // the past fire on the next tick. Returns NO_TIMER if every node is
+    // in use.
+    TimerId arm(uint64_t deadline, uint32_t user);
+
+    void cancel(TimerId id);
+
+    // Steps the clock to now and appends the user value of every timer
+    // that expired on the way. Fired timers are released.
+    void advance(uint64_t now, std::vector<uint32_t>& expired);
+
+    uint64_t now() const { return current; }
+    size_t   active() const { return armed; }
+
+private:
+    static constexpr uint32_t NIL        = ~uint32_t(0);
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+
+    struct Node {
+        uint64_t deadline = 0;
+        uint32_t user     = 0;
+        uint32_t prev     = NIL;
+        uint32_t next     = NIL;
+        uint16_t gen      = 0;
+        uint8_t  level    = 0;
+        uint8_t  slot     = 0;
+        bool     live     = false;
+    };
+
+    void link(uint32_t node);
+    void unlink(uint32_t node);
+    void release(uint32_t node);
+    uint32_t& list_head(const Node& n);
+    void cascade(uint32_t& head);
+
+    std::vector<Node>     nodes;
+    std::vector<uint32_t> free_nodes;
+
+    uint32_t heads[LEVELS][SLOTS];
+    uint32_t overflow = NIL; // level == LEVELS
+
+    uint64_t current = 0;
+    size_t   armed   = 0;
+};
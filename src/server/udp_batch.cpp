@@ -0,0 +1,292 @@
+#include "udp_batch.hpp"
+
+#include <cstring>
+
+#include <netinet/udp.h>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+RecvBatch::RecvBatch(PacketPool& p) : pool(p) {
+    std::memset(msgs, 0, sizeof(msgs));
+
+    for (int i = 0; i < RECV_BATCH_SIZE; ++i) {
+        msgs[i].msg_hdr.msg_iov    = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name   = &addrs[i];
+    }
+}
+
+int RecvBatch::refill() {
+    // Swap out buffers the last batch's consumers held on to
+    int slots_ready = 0;
+    for (; slots_ready < RECV_BATCH_SIZE; ++slots_ready) {
+        PacketRef& slot = slots[slots_ready];
+        if (!slot.unique()) {
+            slot = pool.acquire();
+            if (!slot)
+                break;
+        }
+    }
+
+    return slots_ready;
+}
+
+int RecvBatch::recv(int fd) {
+    const int slots_ready = refill();
+    if (slots_ready == 0)
+        return discard(fd);
+
+    for (int i = 0; i < slots_ready; ++i) {
+        iovs[i].iov_base = slots[i].data();
+        iovs[i].iov_len  = RECV_PACKET_BYTES;
+    }
+
+    // recvmmsg overwrites msg_namelen, so restore it every call
+    for (int i = 0; i < slots_ready; ++i)
+        msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+
+    int n = recvmmsg(fd, msgs, unsigned(slots_ready), MSG_WAITFORONE, nullptr);
+    if (n < 0)
+        return -1;
+
+    for (int i = 0; i < n; ++i)
+        slots[i].resize(msgs[i].msg_len);
+
+    syscalls  += 1;
+    datagrams += uint64_t(n);
+    return n;
+}
+
+int RecvBatch::discard(int fd) {
+    // Every slot reads into the same scratch bytes
+    for (int i = 0; i < RECV_BATCH_SIZE; ++i) {
+        iovs[i].iov_base = scratch;
+        iovs[i].iov_len  = sizeof(scratch);
+        msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    while (true) {
+        int n = recvmmsg(fd, msgs, RECV_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        if (n <= 0)
+            break;
+
+        syscalls += 1;
+        dropped  += uint64_t(n);
+        if (n < RECV_BATCH_SIZE)
+            break;
+    }
+
+    return 0;
+}
+
+int RecvBatch::recv(UdpSocket& socket) {
+    const int slots_ready = refill();
+    if (slots_ready == 0)
+        return discard(socket);
+
+    InPacket in[RECV_BATCH_SIZE];
+    for (int i = 0; i < slots_ready; ++i) {
+        in[i].data     = slots[i].data();
+        in[i].capacity = RECV_PACKET_BYTES;
+    }
+
+    int n = socket.recv_batch(std::span<InPacket>(in, size_t(slots_ready)));
+    if (n < 0)
+        return -1;
+
+    for (int i = 0; i < n; ++i) {
+        slots[i].resize(in[i].size);
+        addrs[i] = in[i].from;
+    }
+
+    syscalls  += 1;
+    datagrams += uint64_t(n);
+    return n;
+}
+
+int RecvBatch::discard(UdpSocket& socket) {
+    InPacket in[RECV_BATCH_SIZE];
+    for (InPacket& p : in) {
+        p.data     = scratch;
+        p.capacity = sizeof(scratch);
+    }
+
+    while (true) {
+        int n = socket.recv_batch(in);
+        if (n <= 0)
+            break;
+
+        syscalls += 1;
+        dropped  += uint64_t(n);
+        if (n < RECV_BATCH_SIZE)
+            break;
+    }
+
+    return 0;
+}
+
+// ------------------------------------------------------------
+// SendBatch
+// ------------------------------------------------------------
+SendBatch::SendBatch() {
+    std::memset(msgs, 0, sizeof(msgs));
+}
+
+void SendBatch::attach(int fd_, bool gso_) {
+    fd   = fd_;
+    gso  = gso_;
+    sink = nullptr;
+}
+
+void SendBatch::attach(UdpSocket* socket) {
+    fd   = -1;
+    gso  = false;
+    sink = socket;
+}
+
+static bool same_addr(const sockaddr_in& a, const sockaddr_in& b) {
+    return a.sin_addr.s_addr == b.sin_addr.s_addr &&
+           a.sin_port == b.sin_port;
+}
+
+void SendBatch::queue(const void* data, size_t size, const sockaddr_in& to) {
+    if (size == 0 || size > SEND_ARENA_BYTES)
+        return;
+
+    // Extend the previous message into a GSO super-packet. Its bytes
+    // are the tail of the arena, so the new segment is contiguous.
+    if (gso && count > 0) {
+        Pending& last = pending[count - 1];
+
+        if (last.seg_size == size &&
+            last.segments < GSO_MAX_SEGMENTS &&
+            last.bytes + size <= GSO_MAX_BYTES &&
+            used + size <= SEND_ARENA_BYTES &&
+            same_addr(last.to, to)) {
+
+            std::memcpy(arena + used, data, size);
+            used          += size;
+            last.bytes    += size;
+            last.segments += 1;
+            return;
+        }
+    }
+
+    if (count == SEND_BATCH_SIZE || used + size > SEND_ARENA_BYTES)
+        flush();
+
+    std::memcpy(arena + used, data, size);
+
+    Pending& p = pending[count++];
+    p.to       = to;
+    p.offset   = used;
+    p.bytes    = size;
+    p.seg_size = uint16_t(size);
+    p.segments = 1;
+
+    used += size;
+}
+
+int SendBatch::flush() {
+    if (count == 0)
+        return 0;
+
+    if (sink) {
+        // Without GSO every pending entry is one datagram
+        for (int i = 0; i < count; ++i)
+            outs[i] = OutPacket{ arena + pending[i].offset, pending[i].bytes,
+                                 pending[i].to };
+
+        int calls = 0;
+        int sent  = 0;
+
+        while (sent < count) {
+            int n = sink->send_batch(
+                std::span<const OutPacket>(outs + sent, size_t(count - sent)));
+            ++calls;
+
+            if (n <= 0) {
+                // Same as below: drop the failed one and go on
+                errors += 1;
+                sent   += 1;
+                continue;
+            }
+
+            datagrams += uint64_t(n);
+            sent      += n;
+        }
+
+        syscalls += uint64_t(calls);
+        batches  += 1;
+
+        count = 0;
+        used  = 0;
+        return calls;
+    }
+
+    // Detached (replay): account for everything, send nothing
+    if (fd < 0) {
+        for (int i = 0; i < count; ++i)
+            datagrams += pending[i].segments;
+
+        batches += 1;
+        count = 0;
+        used  = 0;
+        return 0;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        Pending& p = pending[i];
+        msghdr&  h = msgs[i].msg_hdr;
+
+        iovs[i].iov_base = arena + p.offset;
+        iovs[i].iov_len  = p.bytes;
+
+        h.msg_name       = &p.to;
+        h.msg_namelen    = sizeof(p.to);
+        h.msg_iov        = &iovs[i];
+        h.msg_iovlen     = 1;
+        h.msg_control    = nullptr;
+        h.msg_controllen = 0;
+
+        if (p.segments > 1) {
+            h.msg_control    = control[i];
+            h.msg_controllen = sizeof(control[i]);
+
+            cmsghdr* cm = CMSG_FIRSTHDR(&h);
+            cm->cmsg_level = SOL_UDP;
+            cm->cmsg_type  = UDP_SEGMENT;
+            cm->cmsg_len   = CMSG_LEN(sizeof(uint16_t));
+            std::memcpy(CMSG_DATA(cm), &p.seg_size, sizeof(uint16_t));
+        }
+    }
+
+    int calls = 0;
+    int sent  = 0;
+
+    while (sent < count) {
+        int n = sendmmsg(fd, msgs + sent, unsigned(count - sent), 0);
+        ++calls;
+
+        if (n <= 0) {
+            // The first remaining message failed; drop it and go on
+            errors    += pending[sent].segments;
+            sent      += 1;
+            continue;
+        }
+
+        for (int i = sent; i < sent + n; ++i)
+            datagrams += pending[i].segments;
+
+        sent += n;
+    }
+
+    syscalls += uint64_t(calls);
+    batches  += 1;
+
+    count = 0;
+    used  = 0;
+    return calls;
+}
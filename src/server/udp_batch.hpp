@@ -0,0 +1,139 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "sentinel/net/buffer/packet_pool.hpp"
+#include "sentinel/net/transport/udp_socket.hpp"
+
+// ------------------------------------------------------------
+// Batched datagram receive (recvmmsg)
+// ------------------------------------------------------------
+constexpr int    RECV_BATCH_SIZE   = 64;
+constexpr size_t RECV_PACKET_BYTES = 1500; // one MTU per slot
+
+// Datagrams land in buffers from the pool. A slot whose packet() is
+// still referenced when recv() is next called gets a fresh buffer, so
+// the caller may keep views of anything it received.
+class RecvBatch {
+public:
+    explicit RecvBatch(PacketPool& pool); // buffers >= RECV_PACKET_BYTES
+
+    // Blocks for the first datagram, then drains whatever else is
+    // already queued (up to RECV_BATCH_SIZE) in the same syscall.
+    // Returns the number of datagrams received, or -1 on error.
+    //
+    // With the pool out of buffers it reads the socket empty into a
+    // scratch buffer and returns 0; the datagrams count as `dropped`.
+    // Leaving them queued would keep the socket readable and spin a
+    // level-triggered epoll loop until buffers came back.
+    int recv(int fd);
+
+    // The same from a UdpSocket's recv_batch(), which never waits:
+    // 0 when nothing has arrived
+    int recv(UdpSocket& socket);
+
+    PacketRef&         packet(int i) { return slots[i]; }
+    const uint8_t*     data(int i) const { return slots[i].data(); }
+    size_t             size(int i) const { return slots[i].size(); }
+    const sockaddr_in& from(int i) const { return addrs[i]; }
+
+    // ---- stats (since last reset) ----
+    uint64_t datagrams = 0;
+    uint64_t syscalls  = 0; // recv_batch() calls, from a UdpSocket
+    uint64_t dropped   = 0; // read with no pool buffer to keep them
+
+    double datagrams_per_syscall() const {
+        return syscalls ? double(datagrams) / double(syscalls) : 0.0;
+    }
+
+    void reset_stats() {
+        datagrams = 0;
+        syscalls  = 0;
+        dropped   = 0;
+    }
+
+private:
+    int refill(); // slots with a buffer to read into, from the front
+    int discard(int fd);
+    int discard(UdpSocket& socket);
+
+    PacketPool& pool;
+
+    // Buffers are reused batch to batch unless someone kept them
+    PacketRef   slots[RECV_BATCH_SIZE];
+    sockaddr_in addrs[RECV_BATCH_SIZE];
+    iovec       iovs[RECV_BATCH_SIZE];
+    mmsghdr     msgs[RECV_BATCH_SIZE];
+
+    uint8_t scratch[RECV_PACKET_BYTES]; // discard() target
+};
+
+// ------------------------------------------------------------
+// Batched datagram send (sendmmsg, optional UDP GSO)
+// ------------------------------------------------------------
+constexpr int    SEND_BATCH_SIZE  = 1024;      // sendmmsg vlen cap
+constexpr size_t SEND_ARENA_BYTES = 1 << 20;
+constexpr size_t GSO_MAX_BYTES    = 65000;     // one UDP super-packet
+constexpr int    GSO_MAX_SEGMENTS = 64;
+
+class SendBatch {
+public:
+    SendBatch();
+
+    // gso: coalesce back-to-back equal-sized datagrams to the same
+    // address into one message carrying a UDP_SEGMENT cmsg.
+    void attach(int fd, bool gso);
+
+    // Flushes through the socket's send_batch() instead; no GSO
+    void attach(UdpSocket* socket);
+
+    // Copies the payload; flushes first if the batch is full.
+    void queue(const void* data, size_t size, const sockaddr_in& to);
+
+    // Sends everything queued. Returns the number of syscalls made.
+    int flush();
+
+    // ---- stats (since last reset) ----
+    uint64_t datagrams = 0; // datagrams the kernel put on the wire
+    uint64_t syscalls  = 0; // sendmmsg calls
+    uint64_t batches   = 0; // non-empty flushes
+    uint64_t errors    = 0; // messages dropped by a failed send
+
+    uint64_t syscalls_saved() const {
+        return datagrams > syscalls ? datagrams - syscalls : 0;
+    }
+
+    void reset_stats() {
+        datagrams = 0;
+        syscalls  = 0;
+        batches   = 0;
+        errors    = 0;
+    }
+
+private:
+    struct Pending {
+        sockaddr_in to;
+        size_t      offset;   // into arena
+        size_t      bytes;
+        uint16_t    seg_size;
+        uint16_t    segments;
+    };
+
+    int        fd   = -1;
+    bool       gso  = false;
+    UdpSocket* sink = nullptr;
+
+    Pending pending[SEND_BATCH_SIZE];
+    int     count = 0;
+
+    uint8_t arena[SEND_ARENA_BYTES];
+    size_t  used = 0;
+
+    iovec   iovs[SEND_BATCH_SIZE];
+    mmsghdr msgs[SEND_BATCH_SIZE];
+    uint8_t control[SEND_BATCH_SIZE][CMSG_SPACE(sizeof(uint16_t))];
+    OutPacket outs[SEND_BATCH_SIZE]; // for `sink`
+};
@@ -0,0 +1,66 @@
+#include "world_table.hpp"
+
+#include <cstring>
+#include <thread>
+
+WorldTable::WorldTable(size_t workers) {
+    for (size_t i = 0; i < workers; ++i)
+        slices.push_back(std::make_unique<Slice>());
+}
+
+void WorldTable::publish(size_t worker, const EntityState* entities,
+                         size_t count) {
+    Slice& s = *slices[worker];
+
+    if (count > WORLD_TABLE_SLICE_CAPACITY)
+        count = WORLD_TABLE_SLICE_CAPACITY;
+
+    // Odd seq first, and the fence keeps the writes below from being
+    // seen before it
+    const uint64_t seq  = s.seq.load(std::memory_order_relaxed);
+    const size_t   back = ((seq >> 1) + 1) & 1;
+
+    s.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(s.buf[back], entities, count * sizeof(EntityState));
+    s.count[back].store(uint32_t(count), std::memory_order_relaxed);
+
+    s.seq.store(seq + 2, std::memory_order_release);
+}
+
+void WorldTable::read_all(std::vector<EntityState>& out) const {
+    for (const auto& slice : slices) {
+        const Slice& s = *slice;
+        size_t first = out.size();
+
+        while (true) {
+            uint64_t seq = s.seq.load(std::memory_order_acquire);
+            if (seq == 0)
+                break; // nothing published yet
+            if (seq & 1) {
+                // Mid-publish: `front` is not settled yet
+                std::this_thread::yield();
+                continue;
+            }
+
+            size_t   front = (seq >> 1) & 1;
+            uint32_t count = s.count[front].load(std::memory_order_relaxed);
+            if (count > WORLD_TABLE_SLICE_CAPACITY)
+                count = WORLD_TABLE_SLICE_CAPACITY;
+
+            out.resize(first + count);
+            std::memcpy(out.data() + first, s.buf[front],
+                        count * sizeof(EntityState));
+
+            // The next publish writes the other buffer; only the one
+            // after that (seq + 3) reuses this one. A writer that got
+            // that far is seen here, thanks to the fences.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) <= seq + 2)
+                break;
+
+            out.resize(first);
+        }
+    }
+}
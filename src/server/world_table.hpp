@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "sentinel/net/protocol/snapshot.hpp"
+
+// ------------------------------------------------------------
+// Shared world table (one writer per slice, any number of readers)
+// ------------------------------------------------------------
+// Every worker owns one slice and publishes its players' authoritative
+// state once per tick. Each slice is a seqlock over two buffers: `seq`
+// is odd while the writer fills the back buffer and even once that
+// buffer is the front. Readers retry on an odd `seq`, or when the
+// writer has started a second publish since they looked and so may be
+// overwriting the buffer they copied. The writer never waits on a
+// reader.
+
+constexpr size_t WORLD_TABLE_SLICE_CAPACITY = 4096; // entities per worker
+
+class WorldTable {
+public:
+    explicit WorldTable(size_t workers);
+
+    size_t slice_count() const { return slices.size(); }
+
+    // Owning worker only. Excess entities beyond the slice capacity
+    // are dropped.
+    void publish(size_t worker, const EntityState* entities, size_t count);
+
+    // Appends the latest published state of every slice to `out`
+    void read_all(std::vector<EntityState>& out) const;
+
+private:
+    struct Slice {
+        std::atomic<uint64_t> seq{ 0 };   // 2 per publish
+        std::atomic<uint32_t> count[2] = {};
+        EntityState buf[2][WORLD_TABLE_SLICE_CAPACITY];
+    };
+
+    std::vector<std::unique_ptr<Slice>> slices;
+};
@@ -1,26 +1,17 @@
 #include "sentinel/sim/sim_update.hpp"
 #include <cmath>
 
-void sim_update(
-    SimWorld& world,
-    SimPlayer& p,
-    float dt,
-    float throttle,
-    float strafe,
-    float yaw,
-    float pitch
-) {
-    world.time += dt;
-
-    constexpr float MOVE_SPEED   = 6.0f;
-    constexpr float STRAFE_SPEED = 5.0f;
-    constexpr float TURN_RATE    = 1.8f;
-    constexpr float PITCH_RATE   = 1.4f;
-    constexpr float VERT_SPEED   = 4.0f;
-
+static constexpr float MOVE_SPEED   = 9.0f;
+static constexpr float STRAFE_SPEED = 8.0f;
+static constexpr float VERT_SPEED   = 6.0f;
+static constexpr float TURN_RATE    = 1.8f;
+static constexpr float PITCH_RATE   = 1.4f;
+static constexpr float BOOST_MUL    = 2.0f;
+
+static inline void step_player(SimPlayer& p, const SimInput& in, float dt) {
     // Orientation
-    p.yaw   += yaw   * TURN_RATE  * dt;
-    p.pitch += pitch * PITCH_RATE * dt;
+    p.yaw   += in.yaw   * TURN_RATE  * dt;
+    p.pitch += in.pitch * PITCH_RATE * dt;
 
     if (p.pitch >  1.2f) p.pitch =  1.2f;
     if (p.pitch < -1.2f) p.pitch = -1.2f;
@@ -28,14 +19,39 @@ void sim_update(
     const float cy = std::cos(p.yaw);
     const float sy = std::sin(p.yaw);
 
+    const float mul = in.boost ? BOOST_MUL : 1.0f;
+
     // Forward / backward
-    p.x += cy * throttle * MOVE_SPEED * dt;
-    p.z += sy * throttle * MOVE_SPEED * dt;
+    p.x += cy * in.throttle * MOVE_SPEED * mul * dt;
+    p.z += sy * in.throttle * MOVE_SPEED * mul * dt;
 
     // Strafe
-    p.x += -sy * strafe * STRAFE_SPEED * dt;
-    p.z +=  cy * strafe * STRAFE_SPEED * dt;
+    p.x += -sy * in.strafe * STRAFE_SPEED * mul * dt;
+    p.z +=  cy * in.strafe * STRAFE_SPEED * mul * dt;
 
     // Vertical
-    p.y += throttle * VERT_SPEED * dt;
+    p.y += in.vertical * VERT_SPEED * mul * dt;
+}
+
+void sim_update(
+    SimWorld& world,
+    SimPlayer& p,
+    const SimInput& input,
+    float dt
+) {
+    world.time += dt;
+    step_player(p, input, dt);
+}
+
+void sim_update_batch(
+    SimWorld& world,
+    SimPlayer* players,
+    const SimInput* inputs,
+    size_t count,
+    float dt
+) {
+    world.time += dt;
+
+    for (size_t i = 0; i < count; ++i)
+        step_player(players[i], inputs[i], dt);
 }